@@ -0,0 +1,129 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <fftw_helper.h>
+#include <frame_kernels.h>
+#include <render_model.h>
+#include <synthetic_source.h>
+
+namespace {
+
+using namespace PulseView;
+
+constexpr size_t stereo = 2;
+
+std::vector<S16NESample> makeInterleaved(size_t numSamples, size_t numChannels) {
+    AudioSource::SyntheticSource source{AudioSource::Signal::Noise, 48000, numChannels};
+    std::vector<S16NESample> interleaved(numSamples * numChannels);
+    source.read(interleaved.data(), numSamples);
+    return interleaved;
+}
+
+// The path Frame::finalize used before batching: deinterleave into per-channel vectors, then stage each channel into
+// the plan's input and execute the plan once per channel
+template <typename T> void BM_PerChannelDFT(benchmark::State &state) {
+    const size_t log2Size = state.range(0);
+    const size_t size = ((size_t)1) << log2Size;
+    const T maxSize = std::numeric_limits<S16NESample>::max();
+    fftw::BasicFFTWHelper<T> helper{log2Size, 1};
+    const auto interleaved = makeInterleaved(size, stereo);
+    std::vector<std::vector<T>> samples(stereo, std::vector<T>(size));
+    std::vector<fftw::FFTWVector<T>> dfts(stereo, fftw::FFTWVector<T>(helper.numBins));
+    for (auto _ : state) {
+        for (size_t i = 0; i < size; ++i) {
+            for (size_t c = 0; c < stereo; ++c) {
+                samples[c][i] = interleaved[stereo * i + c] / maxSize;
+            }
+        }
+        for (size_t c = 0; c < stereo; ++c) {
+            std::copy(samples[c].begin(), samples[c].end(), helper.input(0));
+            helper.calculateDFT(dfts[c].data(), helper.numBins);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size * stereo);
+}
+BENCHMARK_TEMPLATE(BM_PerChannelDFT, double)->DenseRange(8, 16);
+BENCHMARK_TEMPLATE(BM_PerChannelDFT, float)->DenseRange(8, 16);
+
+// Deinterleaves straight into the plan's channel-strided input and transforms every channel in one execution, or in
+// parallel channel groups once there are enough channels
+template <typename T> void BM_BatchedDFT(benchmark::State &state) {
+    const size_t log2Size = state.range(0);
+    const size_t numChannels = state.range(1);
+    BasicFrame<T> frame{log2Size, numChannels, fftw::PlannerEffort::Estimate};
+    const auto interleaved = makeInterleaved(frame.numSamples, numChannels);
+    for (auto _ : state) {
+        frame.loadInterleaved(interleaved.data(), numChannels);
+        frame.finalize();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frame.numSamples * numChannels);
+}
+BENCHMARK_TEMPLATE(BM_BatchedDFT, double)->ArgsProduct({benchmark::CreateDenseRange(8, 16, 1), {2, 8, 32}});
+BENCHMARK_TEMPLATE(BM_BatchedDFT, float)->ArgsProduct({benchmark::CreateDenseRange(8, 16, 1), {2, 8, 32}});
+
+// Everything but the transform itself: conversion, windowing, magnitudes and an envelope per channel, through kernels
+// specialised for the size and channel count (1) or the generic ones (0)
+template <typename T> void BM_FrameKernels(benchmark::State &state) {
+    const size_t log2Size = state.range(0);
+    const size_t numChannels = state.range(1);
+    const size_t size = size_t{1} << log2Size;
+    const auto &selected = state.range(2) ? kernels::frameKernels<T>(log2Size, numChannels)
+                                          : kernels::frameKernels<T>(kernels::maxSpecialisedLog2Size + 1, 0);
+    const auto interleaved = makeInterleaved(size, numChannels);
+    fftw::FFTWVector<T> samples(size * numChannels), coefficients(size, 1), windowed(size);
+    fftw::FFTWVector<typename kernels::FrameKernels<T>::Complex> bins(size / 2 + 1);
+    fftw::FFTWVector<T> magnitudes(bins.size());
+    std::vector<T *> rows(numChannels);
+    for (size_t c = 0; c < numChannels; ++c) {
+        rows[c] = samples.data() + c * size;
+    }
+    constexpr size_t numColumns = 800;
+    std::vector<T> mins(numColumns), maxs(numColumns);
+    for (auto _ : state) {
+        selected.load(interleaved.data(), size, numChannels, rows.data());
+        for (size_t c = 0; c < numChannels; ++c) {
+            selected.window(rows[c], coefficients.data(), size, windowed.data());
+            selected.magnitude(bins.data(), size, magnitudes.data());
+            selected.envelope(rows[c], size, numColumns, mins.data(), maxs.data());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size * numChannels);
+    state.SetLabel(selected.specialised ? "specialised" : "generic");
+}
+BENCHMARK_TEMPLATE(BM_FrameKernels, double)->ArgsProduct({{8, 12, 16}, {2, 8}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_FrameKernels, float)->ArgsProduct({{8, 12, 16}, {2, 8}, {0, 1}});
+
+// A stereo frame planned with FFTW splitting each transform over the given number of threads, to find the size where
+// that starts to beat a single threaded plan (which sets defaultThreadedLog2Size)
+template <typename T> void BM_ThreadedDFT(benchmark::State &state) {
+    const size_t log2Size = state.range(0);
+    fftw::setPlannerThreads(state.range(1), 0);
+    BasicFrame<T> frame{log2Size, stereo, fftw::PlannerEffort::Estimate};
+    fftw::setPlannerThreads(1);
+    const auto interleaved = makeInterleaved(frame.numSamples, stereo);
+    frame.loadInterleaved(interleaved.data(), stereo);
+    for (auto _ : state) {
+        frame.finalize();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frame.numSamples * stereo);
+}
+BENCHMARK_TEMPLATE(BM_ThreadedDFT, double)
+    ->ArgsProduct({benchmark::CreateDenseRange(12, 20, 2), {1, 2, 4, 8}})
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ThreadedDFT, float)
+    ->ArgsProduct({benchmark::CreateDenseRange(12, 20, 2), {1, 2, 4, 8}})
+    ->UseRealTime();
+
+} // namespace
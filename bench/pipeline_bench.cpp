@@ -0,0 +1,180 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <render_model.h>
+#include <synthetic_source.h>
+
+namespace {
+
+using namespace PulseView;
+using AudioSource::Signal;
+using AudioSource::SyntheticSource;
+
+constexpr size_t sampleRate = 48000;
+constexpr unsigned width = 800;
+constexpr unsigned height = 600;
+constexpr size_t numBars = 128;
+
+const char *signalName(Signal signal) {
+    switch (signal) {
+    case Signal::Sine:
+        return "sine";
+    case Signal::Chirp:
+        return "chirp";
+    case Signal::Noise:
+        return "noise";
+    case Signal::Silence:
+        return "silence";
+    }
+    return "";
+}
+
+void frameWidths(benchmark::internal::Benchmark *b) { b->DenseRange(8, 16); }
+
+void frameWidthsAndSignals(benchmark::internal::Benchmark *b) {
+    for (int log2Size = 8; log2Size <= 16; ++log2Size) {
+        for (auto signal : {Signal::Sine, Signal::Chirp, Signal::Noise, Signal::Silence}) {
+            b->Args({log2Size, static_cast<int>(signal)});
+        }
+    }
+}
+
+// A frame holding one window of noise, analysed and ready to draw
+struct LoadedFrame {
+    explicit LoadedFrame(size_t log2Size) : frame{log2Size} { source.populateFrame(frame); }
+    SyntheticSource source{Signal::Noise, sampleRate};
+    Frame frame;
+};
+
+// Generation, conversion and the DFT, i.e. everything a source does per frame apart from waiting for audio
+void BM_PopulateFrame(benchmark::State &state) {
+    const auto signal = static_cast<Signal>(state.range(1));
+    Frame frame{static_cast<size_t>(state.range(0))};
+    SyntheticSource source{signal, sampleRate};
+    for (auto _ : state) {
+        source.populateFrame(frame);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(signalName(signal));
+    state.SetItemsProcessed(state.iterations() * frame.numSamples);
+}
+BENCHMARK(BM_PopulateFrame)->Apply(frameWidthsAndSignals);
+
+void BM_Conversion(benchmark::State &state) {
+    LoadedFrame loaded{static_cast<size_t>(state.range(0))};
+    auto &frame = loaded.frame;
+    std::vector<S16NESample> interleaved(frame.numSamples * frame.numChannels);
+    loaded.source.read(interleaved.data(), frame.numSamples);
+    for (auto _ : state) {
+        frame.loadInterleaved(interleaved.data(), frame.numChannels);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frame.numSamples);
+}
+BENCHMARK(BM_Conversion)->Apply(frameWidths);
+
+void BM_CalculateDFT(benchmark::State &state) {
+    LoadedFrame loaded{static_cast<size_t>(state.range(0))};
+    auto &frame = loaded.frame;
+    for (auto _ : state) {
+        frame.fftw.calculateDFT(frame.spectra.data(), frame.dftStride);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frame.numSamples);
+}
+BENCHMARK(BM_CalculateDFT)->Apply(frameWidths);
+
+// The per-bar bin averaging drawFrame did before SpectrumLayout
+void BM_DftValueOverRange(benchmark::State &state) {
+    LoadedFrame loaded{static_cast<size_t>(state.range(0))};
+    const auto &chunk = loaded.frame.getChunk(0);
+    for (auto _ : state) {
+        for (size_t i = 0; i < numBars; ++i) {
+            benchmark::DoNotOptimize(chunk.getDftValueOverRange(i, i + 1, numBars));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numBars);
+}
+BENCHMARK(BM_DftValueOverRange)->Apply(frameWidths);
+
+// One min and max per pixel column, the way the envelope was first drawn
+void BM_MinMaxInRange(benchmark::State &state) {
+    LoadedFrame loaded{static_cast<size_t>(state.range(0))};
+    const auto &chunk = loaded.frame.getChunk(0);
+    for (auto _ : state) {
+        for (size_t x = 0; x < width; ++x) {
+            benchmark::DoNotOptimize(chunk.minInRange(x, x + 1, width));
+            benchmark::DoNotOptimize(chunk.maxInRange(x, x + 1, width));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * width);
+}
+BENCHMARK(BM_MinMaxInRange)->Apply(frameWidths);
+
+void BM_MinMaxEnvelope(benchmark::State &state) {
+    LoadedFrame loaded{static_cast<size_t>(state.range(0))};
+    const auto &chunk = loaded.frame.getChunk(0);
+    std::vector<Sample> mins(width), maxs(width);
+    for (auto _ : state) {
+        chunk.minMaxEnvelope(width, mins.data(), maxs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * width);
+}
+BENCHMARK(BM_MinMaxEnvelope)->Apply(frameWidths);
+
+// Vertex building alone, which needs no OpenGL context
+void BM_BuildGeometry(benchmark::State &state) {
+    LoadedFrame loaded{static_cast<size_t>(state.range(0))};
+    sf::RenderTexture target;
+    RenderModel model{target};
+    for (auto _ : state) {
+        model.buildGeometry(loaded.frame, width, height);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_BuildGeometry)->Apply(frameWidths);
+
+// Vertex building plus submitting the draws to an offscreen target. The GPU finishes asynchronously, so this measures
+// the CPU side of drawing.
+void BM_DrawFrame(benchmark::State &state) {
+    LoadedFrame loaded{static_cast<size_t>(state.range(0))};
+    sf::RenderTexture target;
+    if (!target.create(width, height)) {
+        state.SkipWithError("Failed to create an offscreen render target");
+        return;
+    }
+    RenderModel model{target};
+    for (auto _ : state) {
+        model.drawFrame(loaded.frame);
+        target.display();
+    }
+}
+BENCHMARK(BM_DrawFrame)->Apply(frameWidths);
+
+// CPU time of a frame at 3840x2160, with the vertices streamed through a vertex buffer (1) or drawn from client memory
+// (0) like the vertex arrays they replaced
+void BM_DrawFrame4K(benchmark::State &state) {
+    LoadedFrame loaded{static_cast<size_t>(state.range(0))};
+    sf::RenderTexture target;
+    if (!target.create(3840, 2160)) {
+        state.SkipWithError("Failed to create an offscreen render target");
+        return;
+    }
+    RenderModel model{target};
+    model.useVertexBuffer(state.range(1));
+    for (auto _ : state) {
+        model.drawFrame(loaded.frame);
+        target.display();
+    }
+    state.SetLabel(state.range(1) ? "vertex buffer" : "client arrays");
+}
+BENCHMARK(BM_DrawFrame4K)->ArgsProduct({{11, 14}, {0, 1}});
+
+} // namespace
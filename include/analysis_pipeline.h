@@ -0,0 +1,111 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "capture_thread.h"
+#include "frame_cache.h"
+#include "pulseview.h"
+#include "render_model.h"
+#include "signal_history.h"
+
+namespace PulseView {
+
+struct PipelineMetrics {
+    // Frames whose conversion and DFT completed
+    uint64_t framesAnalysed;
+    // Completed frames that were superseded by a newer one before they could be drawn
+    uint64_t framesDropped;
+};
+
+// Runs conversion and the DFT on worker threads, so frame N + 1 is analysed while frame N is drawn. Frames rotate
+// through a pool of numWorkers + 2 (one per worker, the newest analysed one and the one being drawn), each with its
+// own FFTW plan, so with one worker this is triple buffering. New audio is only handed out when a worker is idle, and
+// only the newest analysed frame is ever drawn, so a slow stage delays the picture by at most one frame.
+//
+// The frames come from a FrameCache as a set per size, so changing the size prepares a set in the background (or finds
+// the one from last time) while the old one keeps being analysed and drawn, then moves each slot over to the new set
+// once it's free. Workers apply the window to each frame they analyse, so changing it costs the render thread nothing.
+class AnalysisPipeline {
+  public:
+    AnalysisPipeline() = delete;
+    AnalysisPipeline(CaptureThread &capture, size_t numChannels, size_t log2NumSamples, size_t numWorkers,
+                     fftw::PlannerEffort plannerEffort = fftw::PlannerEffort::Measure,
+                     fftw::WindowFunction windowFunction = fftw::WindowFunction::Rectangular);
+    AnalysisPipeline(const AnalysisPipeline &) = delete;
+    AnalysisPipeline &operator=(const AnalysisPipeline &) = delete;
+    ~AnalysisPipeline() noexcept;
+    // Called from the render thread. Hands any new audio to an idle worker and picks up the newest analysed frame,
+    // returns whether that changed what newest() returns.
+    bool update();
+    // The frame to draw, unchanged until the next update(). Null until the first frame has been analysed.
+    const Frame *newest() const noexcept { return rendering_ ? rendering_->frame : nullptr; }
+    PipelineMetrics metrics() const noexcept;
+    FrameCacheMetrics frameCacheMetrics() const { return frames_.metrics(); }
+    // Replaces the current window with a whole window of interleaved frames, which is analysed on the next update()
+    void seed(const S16NESample *interleaved);
+    // Switches sizes once a set of that size is ready, seeding the new window from history if there is one and
+    // otherwise from as much of the old window as fits
+    void setFFTSize(size_t log2NumSamples);
+    // Applies to every frame handed out from the next update() on, which reanalyses the current window
+    void setWindowFunction(fftw::WindowFunction windowFunction);
+    // May be null, and must otherwise outlive this
+    void setHistory(const SignalHistory *history) noexcept { history_ = history; }
+
+  private:
+    enum class SlotState { Free, Queued, Analysing, Ready, Rendering };
+    struct Slot {
+        // Kept alive by set, which is only rebound while the slot is free
+        Frame *frame{nullptr};
+        std::shared_ptr<FrameSet> set;
+        // The whole window as interleaved samples, converted by the worker
+        std::vector<S16NESample> window;
+        fftw::WindowFunction windowFunction{fftw::WindowFunction::Rectangular};
+        uint64_t sequence{0};
+        SlotState state{SlotState::Free};
+    };
+    void work() noexcept;
+    void slideWindow(size_t numFrames);
+    void switchSet(std::shared_ptr<FrameSet> set);
+    // Moves a free slot over to the current set
+    void bind(Slot &slot);
+    Slot *findSlot(SlotState state) noexcept;
+    CaptureThread &capture_;
+    size_t numChannels_;
+    size_t windowFrames_;
+    size_t numWorkers_;
+    // Only touched by the render thread
+    FrameCache frames_;
+    std::shared_ptr<FrameSet> set_;
+    std::shared_ptr<PendingFrameSet> pendingSet_;
+    fftw::WindowFunction windowFunction_;
+    const SignalHistory *history_{nullptr};
+    // The current window, slid along on the render thread as audio arrives
+    std::vector<S16NESample> window_;
+    std::vector<S16NESample> pending_;
+    bool windowChanged_{false};
+    std::vector<Slot> slots_;
+    // Only touched by the render thread
+    Slot *rendering_{nullptr};
+    // The rest is guarded by mutex_
+    mutable std::mutex mutex_;
+    std::condition_variable queued_;
+    Slot *ready_{nullptr};
+    size_t busyWorkers_{0};
+    uint64_t nextSequence_{0};
+    uint64_t framesAnalysed_{0};
+    uint64_t framesDropped_{0};
+    bool running_{true};
+    std::vector<std::thread> workers_;
+};
+
+} // namespace PulseView
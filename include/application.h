@@ -6,13 +6,31 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include <SFML/Graphics.hpp>
 
+#include "analysis_pipeline.h"
+#include "capture_thread.h"
+#include "file_source.h"
+#include "frame_cache.h"
+#include "frame_pacer.h"
+#include "frame_sink.h"
+#include "frame_switcher.h"
+#include "frame_trace.h"
+#include "latency_overlay.h"
+#include "latency_stats.h"
+#include "loudness_meter.h"
 #include "pcm_process_source.h"
 #include "pulseaudio_source.h"
+#include "pulseaudio_stream_source.h"
 #include "pulseview.h"
+#include "recorder.h"
 #include "render_model.h"
+#include "signal_history.h"
 #include "source.h"
 
 namespace PulseView {
@@ -20,14 +38,98 @@ namespace PulseView {
 class Application {
   public:
     Application() = delete;
-    Application(sf::RenderWindow &window, AudioSource::Source &source, Frame &frame);
+    // hopFrames is how far the analysis window moves between updates, i.e. the granularity audio is captured in
+    Application(sf::RenderWindow &window, AudioSource::Source &source, Frame &frame, size_t hopFrames);
     void run();
+    CaptureMetrics captureMetrics() const noexcept { return capture_.metrics(); }
+    RenderModel &renderModel() noexcept { return model_; }
+    const LatencyStats &latencyStats() const noexcept { return stats_; }
+    // F3 toggles the overlay while running
+    LatencyOverlay &latencyOverlay() noexcept { return overlay_; }
+    void showLatencyOverlay(bool show) noexcept { showOverlay_ = show; }
+    // Records every frame's timings to trace, which must outlive run()
+    void setFrameTrace(FrameTrace *trace) noexcept { trace_ = trace; }
+    // Moves conversion and the DFT onto numWorkers threads, after which the frame passed to the constructor is only
+    // drawn until the first one is analysed. Quality no longer degrades as far as SmallerFFT.
+    void enablePipeline(size_t numWorkers, fftw::PlannerEffort plannerEffort);
+    std::optional<PipelineMetrics> pipelineMetrics() const noexcept;
+    // Schedules frames and sheds load when they run over budget
+    FramePacer &framePacer() noexcept { return pacer_; }
+    const PacingMetrics &pacingMetrics() const noexcept { return pacer_.metrics(); }
+    // Keeps the last capacityFrames frames in a SignalHistory, mapped onto backingPath unless that's empty. The mouse
+    // wheel then zooms the waveforms out over it, shift with the wheel, the horizontal wheel or the arrow keys pan
+    // back and forth, and Home returns to the live frame.
+    void enableHistory(size_t capacityFrames, const std::string &backingPath = {});
+    // Records everything captured from then on through recorder, which must outlive this. F5 saves its pre-trigger
+    // ring to snapshotPrefix followed by the time.
+    void setRecorder(Recorder *recorder, const std::string &snapshotPrefix);
+    // Both can also be changed while running, [ and ] halving and doubling the FFT size and W cycling the window, while
+    // - and = halve and double the number of bars. Neither touches the source. See FrameSwitcher for how frames of
+    // other sizes than the one passed to the constructor are prepared without a hitch.
+    void setFFTSize(size_t log2Size);
+    void setWindowFunction(fftw::WindowFunction window);
+    // Of the application's and the pipeline's caches together
+    FrameCacheMetrics frameCacheMetrics() const;
+    // Meters everything captured from then on, including audio too stale to show, and draws the meters over the
+    // frame. M toggles the meters while running, which keeps metering, and R resets integrated loudness and the
+    // maximum true peaks.
+    void enableMeters(size_t sampleRate);
+    // Null until enableMeters
+    const LoudnessMeter *loudnessMeter() const noexcept { return meter_.get(); }
 
   private:
+    // The size the current quality calls for
+    size_t wantedLog2Size() const noexcept;
+    void zoomHistory(float delta, int x);
+    void panHistory(float delta);
+    // end is where the view would end, clamped to what the history holds
+    void setHistoryView(double end, uint64_t spanFrames);
     sf::RenderWindow &window_;
     RenderModel model_;
     Frame &frame_;
     AudioSource::Source &source_;
+    LatencyStats stats_;
+    CaptureThread capture_;
+    std::optional<AnalysisPipeline> pipeline_;
+    // Unused with the pipeline, other than drawing frame_ until its first frame is ready
+    FrameSwitcher analysed_;
+    size_t log2Size_;
+    fftw::WindowFunction windowFunction_{fftw::WindowFunction::Rectangular};
+    LatencyOverlay overlay_;
+    bool showOverlay_{false};
+    FrameTrace *trace_{nullptr};
+    FramePacer pacer_;
+    Recorder *recorder_{nullptr};
+    std::string snapshotPrefix_;
+    std::unique_ptr<SignalHistory> history_;
+    HistoryView historyView_{};
+    std::unique_ptr<LoudnessMeter> meter_;
+    bool showMeters_{true};
+};
+
+// Renders a recording offscreen as fast as the CPU allows, one frame per hop, until the file runs out
+class OfflineApplication {
+  public:
+    OfflineApplication() = delete;
+    // sink may be null to render without saving anything, e.g. to time the pipeline
+    OfflineApplication(sf::RenderTexture &texture, AudioSource::FileSource &source, Frame &frame, size_t hopFrames,
+                       FrameSink *sink);
+    // Returns the number of frames rendered
+    size_t run();
+    RenderModel &renderModel() noexcept { return model_; }
+    // Meters every hop and draws the meters over each frame
+    void enableMeters(size_t sampleRate);
+    const LoudnessMeter *loudnessMeter() const noexcept { return meter_.get(); }
+
+  private:
+    sf::RenderTexture &texture_;
+    RenderModel model_;
+    Frame &frame_;
+    AudioSource::FileSource &source_;
+    size_t hopFrames_;
+    FrameSink *sink_;
+    std::vector<S16NESample> hop_;
+    std::unique_ptr<LoudnessMeter> meter_;
 };
 
 } // namespace PulseView
@@ -0,0 +1,100 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "latency_stats.h"
+#include "loudness_meter.h"
+#include "pulseview.h"
+#include "recorder.h"
+#include "render_model.h"
+#include "signal_history.h"
+#include "source.h"
+#include "spsc_ring.h"
+
+namespace PulseView {
+
+struct CaptureMetrics {
+    // Frames read from the source
+    uint64_t framesCaptured;
+    // Times the ring was full when a block arrived, so the block was dropped
+    uint64_t overruns;
+    uint64_t droppedFrames;
+    // Times populateFrame found no new audio in the ring
+    uint64_t underruns;
+    // Frames discarded without being shown because more than a window arrived between two frames
+    uint64_t staleFrames;
+};
+
+struct CaptureTiming {
+    // When the newest block in the ring finished reading
+    LatencyClock::time_point capturedAt;
+    // The source's own latency for that block
+    uint64_t sourceLatencyMicros;
+};
+
+// Reads a Source on its own thread into a ring of raw interleaved samples, so the render loop never blocks on audio
+class CaptureThread {
+  public:
+    CaptureThread() = delete;
+    // With stats, each read's duration and the source's reported latency are recorded from the capture thread
+    CaptureThread(AudioSource::Source &source, size_t windowFrames, size_t blockFrames, LatencyStats *stats = nullptr);
+    CaptureThread(const CaptureThread &) = delete;
+    CaptureThread &operator=(const CaptureThread &) = delete;
+    ~CaptureThread() noexcept;
+    // Slides frame forward over everything captured since the last call (at most frame.numSamples frames), returns
+    // false without touching frame if nothing new arrived. frame may be any size, not just windowFrames. Rethrows
+    // anything the source threw on the capture thread.
+    bool populateFrame(Frame &frame);
+    // Copies out everything captured since the last call, keeping only the newest maxFrames frames, and returns the
+    // number of frames copied. Counts an underrun when that's 0. Rethrows like populateFrame.
+    size_t pop(S16NESample *interleaved, size_t maxFrames);
+    CaptureMetrics metrics() const noexcept;
+    // Appends everything popped to history from then on, including what's too stale to show, on the consuming thread
+    void setHistory(SignalHistory *history) noexcept { history_ = history; }
+    // Feeds everything popped to meter from then on, stale audio included, on the consuming thread. populateFrame
+    // meters each block as it converts it.
+    void setMeter(LoudnessMeter *meter) noexcept { meter_ = meter; }
+    // Pushes every block read from then on to recorder from the capture thread, before anything can drop it.
+    // recorder must outlive this.
+    void setRecorder(Recorder *recorder) noexcept { recorder_.store(recorder, std::memory_order_release); }
+    // Timing of the newest block read so far, only tracked when constructed with stats
+    CaptureTiming newestCapture() const noexcept;
+
+  private:
+    void run() noexcept;
+    // pop without metering what it returns
+    size_t popFrames(S16NESample *interleaved, size_t maxFrames);
+    AudioSource::Source &source_;
+    size_t numChannels_;
+    size_t windowFrames_;
+    size_t blockFrames_;
+    LatencyStats *stats_;
+    SignalHistory *history_{nullptr};
+    LoudnessMeter *meter_{nullptr};
+    std::atomic<Recorder *> recorder_{nullptr};
+    SPSCRing<S16NESample> ring_;
+    // Frames popped from the ring but not yet converted, only touched by the consumer
+    fftw::FFTWVector<S16NESample> pending_;
+    std::atomic<bool> running_{true};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+    std::atomic<uint64_t> framesCaptured_{0};
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<uint64_t> droppedFrames_{0};
+    std::atomic<uint64_t> underruns_{0};
+    std::atomic<uint64_t> staleFrames_{0};
+    std::atomic<LatencyClock::rep> newestCaptureTicks_{0};
+    std::atomic<uint64_t> newestSourceLatency_{0};
+    std::thread thread_;
+};
+
+} // namespace PulseView
@@ -5,55 +5,186 @@
 
 #pragma once
 
+#include <cstdlib>
 #include <limits>
 #include <memory>
 #include <new>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include <fftw3.h>
 
+#include <pulseview.h>
+
+namespace PulseView::kernels {
+template <typename T> struct FrameKernels;
+} // namespace PulseView::kernels
+
 namespace PulseView::fftw {
 
-struct FFTWComplex {
-    fftw_complex value;
+// Maps a sample type onto the matching FFTW API, fftw_* for double and fftwf_* for float
+template <typename T> struct FFTWTraits;
+
+template <> struct FFTWTraits<double> {
+    using Complex = fftw_complex;
+    using PlanStruct = fftw_plan_s;
+    static constexpr auto planManyR2C = fftw_plan_many_dft_r2c;
+    static constexpr auto initThreads = fftw_init_threads;
+    static constexpr auto planWithNthreads = fftw_plan_with_nthreads;
+    static constexpr auto execute = fftw_execute;
+    static constexpr auto executeR2C = fftw_execute_dft_r2c;
+    static constexpr auto destroyPlan = fftw_destroy_plan;
+    static constexpr auto exportWisdom = fftw_export_wisdom;
+    static constexpr auto importWisdomFromFilename = fftw_import_wisdom_from_filename;
+    static constexpr auto exportWisdomToFilename = fftw_export_wisdom_to_filename;
+    static constexpr const char *wisdomFile = "fftw-wisdom";
+    static constexpr const char *wisdomEnv = "PULSEVIEW_FFTW_WISDOM";
+};
+
+template <> struct FFTWTraits<float> {
+    using Complex = fftwf_complex;
+    using PlanStruct = fftwf_plan_s;
+    static constexpr auto planManyR2C = fftwf_plan_many_dft_r2c;
+    static constexpr auto initThreads = fftwf_init_threads;
+    static constexpr auto planWithNthreads = fftwf_plan_with_nthreads;
+    static constexpr auto execute = fftwf_execute;
+    static constexpr auto executeR2C = fftwf_execute_dft_r2c;
+    static constexpr auto destroyPlan = fftwf_destroy_plan;
+    static constexpr auto exportWisdom = fftwf_export_wisdom;
+    static constexpr auto importWisdomFromFilename = fftwf_import_wisdom_from_filename;
+    static constexpr auto exportWisdomToFilename = fftwf_export_wisdom_to_filename;
+    static constexpr const char *wisdomFile = "fftwf-wisdom";
+    static constexpr const char *wisdomEnv = "PULSEVIEW_FFTWF_WISDOM";
 };
 
+template <typename T> struct BasicFFTWComplex {
+    typename FFTWTraits<T>::Complex value;
+};
+
+using FFTWComplex = BasicFFTWComplex<double>;
+
 static_assert(sizeof(FFTWComplex) == sizeof(fftw_complex));
+static_assert(sizeof(BasicFFTWComplex<float>) == sizeof(fftwf_complex));
+
+constexpr size_t cacheLineSize = 64;
 
+// Rounds a count of T up so consecutive rows of that many elements each start on a cache line
+template <typename T> constexpr size_t cacheLineStride(size_t n) noexcept {
+    constexpr size_t perLine = cacheLineSize / sizeof(T);
+    return (n + perLine - 1) / perLine * perLine;
+}
+
+// Cache line aligned, which is at least the SIMD alignment fftw_malloc would give, so it serves both precisions and
+// rows laid out with cacheLineStride never share a line
 template <typename T> struct FFTWAllocator {
     typedef T value_type;
-    static_assert(std::is_same<value_type, FFTWComplex>::value);
+    static_assert(std::is_trivially_copyable<value_type>::value);
 
     FFTWAllocator() = default;
     template <typename U> constexpr FFTWAllocator(const FFTWAllocator<U> &) noexcept {}
 
     [[nodiscard]] T *allocate(std::size_t n) {
-        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+        if (n > (std::numeric_limits<std::size_t>::max() - cacheLineSize) / sizeof(T)) {
             throw std::bad_alloc();
         }
 
-        if (auto p = static_cast<T *>(fftw_malloc(sizeof(T) * n))) {
+        const auto bytes = (sizeof(T) * n + cacheLineSize - 1) / cacheLineSize * cacheLineSize;
+        if (auto p = static_cast<T *>(std::aligned_alloc(cacheLineSize, bytes))) {
             return p;
         }
 
         throw std::bad_alloc();
     }
 
-    void deallocate(T *p, std::size_t) noexcept { fftw_free(p); }
+    void deallocate(T *p, std::size_t) noexcept { std::free(p); }
 };
 
+template <typename T, typename U> bool operator==(const FFTWAllocator<T> &, const FFTWAllocator<U> &) { return true; }
+template <typename T, typename U> bool operator!=(const FFTWAllocator<T> &, const FFTWAllocator<U> &) { return false; }
+
+template <typename T> using FFTWVector = std::vector<T, FFTWAllocator<T>>;
+
 using FFTWPlan = fftw_plan_s;
 
 static_assert(std::is_same<FFTWPlan *, fftw_plan>::value);
-
-struct FFTWHelper {
-    FFTWHelper() = delete;
-    FFTWHelper(size_t log2NumSamples);
-    void calculateDFT(const std::vector<double> &in, std::vector<double> &out);
+static_assert(std::is_same<FFTWTraits<float>::PlanStruct *, fftwf_plan>::value);
+
+// What calculateDFT writes for each of the size / 2 + 1 bins
+enum class SpectrumMode { Magnitude, Power };
+
+// How hard FFTW searches for a fast plan. Anything above Estimate is only slow the first time a size is planned on a
+// given machine, after that the plan is recreated from the wisdom cache.
+enum class PlannerEffort { Estimate, Measure, Patient };
+
+// Applied to each channel's samples before transforming them, scaled by their mean so a sinusoid's peak keeps the
+// same height whichever is used. Rectangular leaves samples as they are.
+enum class WindowFunction { Rectangular, Hann, Hamming, Blackman };
+constexpr size_t numWindowFunctions = 4;
+
+const char *windowFunctionName(WindowFunction window) noexcept;
+
+// Below this size splitting a single transform over threads costs more than it saves, see BM_ThreadedDFT
+constexpr size_t defaultThreadedLog2Size = 15;
+
+// Plans for transforms of at least 2^minLog2Size points are made multithreaded, FFTW itself splitting each one over
+// numThreads threads, and 1 keeps every plan single threaded. Only applies to plans made afterwards, and should be
+// called before any plan is made.
+void setPlannerThreads(size_t numThreads, size_t minLog2Size = defaultThreadedLog2Size);
+
+// Transforms every channel of a frame with a batched plan. Channel c occupies fftw_in[c * size, (c + 1) * size), so
+// callers write samples straight into the plan's input rather than staging them. Frames with many channels are split
+// into groups of channels that are transformed in parallel on TaskPool::shared(), through one plan executed on each
+// group's arrays, unless the size is large enough for multithreaded plans, which then cover every channel.
+template <typename T> struct BasicFFTWHelper {
+    using Traits = FFTWTraits<T>;
+    using Complex = BasicFFTWComplex<T>;
+    BasicFFTWHelper() = delete;
+    BasicFFTWHelper(size_t log2NumSamples, size_t numChannels, SpectrumMode mode = SpectrumMode::Magnitude,
+                    PlannerEffort effort = PlannerEffort::Measure);
+    BasicFFTWHelper(const BasicFFTWHelper &) = delete;
+    BasicFFTWHelper &operator=(const BasicFFTWHelper &) = delete;
+    T *input(size_t channel) noexcept { return fftw_in.data() + channel * size; }
+    // Windowing transforms a windowed copy of the input, which is only allocated the first time it's needed
+    void setWindow(WindowFunction window);
+    // Writes the numBins values for channel c to out[c * outStride, c * outStride + numBins), each of which must start
+    // on a cache line
+    void calculateDFT(T *out, size_t outStride);
     size_t size;
-    std::vector<FFTWComplex, FFTWAllocator<FFTWComplex>> fftw_in;
-    std::vector<FFTWComplex, FFTWAllocator<FFTWComplex>> fftw_out;
-    std::unique_ptr<FFTWPlan, void (*)(FFTWPlan *)> plan;
+    size_t numBins;
+    size_t numChannels;
+    SpectrumMode mode;
+    // Complex bins between the starts of consecutive channels in fftw_out, padded to a cache line
+    size_t binStride;
+    size_t channelsPerGroup;
+    // Channel groups transformed in parallel, 1 to transform everything on the calling thread
+    size_t numGroups;
+    // Windowing and the magnitudes, specialised for this size and channel count when there are kernels for them
+    const kernels::FrameKernels<T> *kernels;
+    FFTWVector<T> fftw_in;
+    FFTWVector<Complex> fftw_out;
+    using Plan = std::unique_ptr<typename Traits::PlanStruct, void (*)(typename Traits::PlanStruct *)>;
+    // Covers channelsPerGroup channels, and the whole frame when numGroups is 1
+    Plan plan;
+    // Covers the last group when numChannels isn't a multiple of channelsPerGroup
+    Plan tailPlan;
+    WindowFunction window{WindowFunction::Rectangular};
+    // size coefficients, empty for Rectangular
+    FFTWVector<T> windowCoefficients;
+    // Laid out like fftw_in, so the plans' alignment holds for it too
+    FFTWVector<T> windowed;
+
+  private:
+    void transformGroup(size_t group, T *out, size_t outStride);
 };
 
+extern template struct BasicFFTWHelper<double>;
+extern template struct BasicFFTWHelper<float>;
+
+using FFTWHelper = BasicFFTWHelper<Sample>;
+
+// Location of the persisted wisdom, $PULSEVIEW_FFTW_WISDOM or $XDG_CACHE_HOME/pulseview/fftw-wisdom (fftwf-wisdom and
+// $PULSEVIEW_FFTWF_WISDOM for float). Empty if neither that nor $HOME is set, in which case wisdom is not persisted.
+template <typename T> std::string wisdomPath();
+
 } // namespace PulseView::fftw
@@ -0,0 +1,47 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <string>
+
+#include "pulseview.h"
+#include "render_model.h"
+#include "source.h"
+
+namespace PulseView::AudioSource {
+
+// Plays back a mapped recording instead of live audio. Files with a RIFF/WAVE header must hold 16 bit PCM, in any
+// number of channels, anything else is read as raw interleaved S16NE at rawSampleRate with rawChannels channels.
+// Reads never block, and past the end of the file they return silence.
+class FileSource : public Source {
+  public:
+    FileSource() = delete;
+    FileSource(const std::string &path, size_t rawSampleRate, size_t rawChannels = 2);
+    FileSource(const FileSource &) = delete;
+    FileSource &operator=(const FileSource &) = delete;
+    ~FileSource() noexcept;
+    void populateFrame(PulseView::Frame &frame);
+    void read(S16NESample *buffer, size_t numFrames);
+    size_t numChannels() const noexcept { return numChannels_; }
+    size_t sampleRate() const noexcept { return sampleRate_; }
+    size_t numFrames() const noexcept { return numFrames_; }
+    // True once every frame in the file has been read
+    bool finished() const noexcept { return position_ >= numFrames_; }
+
+  private:
+    void parseWav(const unsigned char *data, size_t size);
+    void *map_{nullptr};
+    size_t mapSize_{0};
+    const unsigned char *samples_{nullptr};
+    size_t numChannels_;
+    size_t sampleRate_;
+    size_t numFrames_{0};
+    size_t position_{0};
+    // Reused by populateFrame, so it only allocates when the frame width grows
+    fftw::FFTWVector<S16NESample> buffer_;
+};
+
+} // namespace PulseView::AudioSource
@@ -0,0 +1,98 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fftw_helper.h"
+#include "render_model.h"
+
+namespace PulseView {
+
+struct FrameCacheMetrics {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+// Every frame one user of a FrameCache needs at one size, e.g. one per slot of an AnalysisPipeline
+struct FrameSet {
+    size_t log2Size;
+    // Unique to this set, so a set built after another of the same size was evicted is never mistaken for it
+    uint64_t generation;
+    std::vector<std::unique_ptr<Frame>> frames;
+};
+
+// A set being prepared by FrameCache::prepare
+class PendingFrameSet {
+  public:
+    size_t log2Size() const noexcept { return log2Size_; }
+    // The set once it's been prepared, null until then
+    std::shared_ptr<FrameSet> ready() const;
+
+  private:
+    friend class FrameCache;
+    explicit PendingFrameSet(size_t log2Size) : log2Size_{log2Size} {}
+    size_t log2Size_;
+    mutable std::mutex mutex_;
+    std::shared_ptr<FrameSet> set_;
+};
+
+// Sets of frames of recently used sizes, one set per power of two, each keeping its plans and buffers so switching back
+// to a size neither plans nor allocates. New sizes are planned with Estimate effort, which is quick even for 2^20
+// points and still picks up wisdom saved by a more thorough planner. Holds up to capacity sets and evicts the least
+// recently used, though anyone still holding an evicted set keeps it alive until they let go.
+//
+// prepare() does the slow part, planning and allocating a missing set and anything else the caller needs done to it, on
+// TaskPool::shared(), so the render thread carries on drawing the current frame until the new one is ready. The cache's
+// own preparations run one at a time in the order asked for.
+class FrameCache {
+  public:
+    using Prepare = std::function<void(FrameSet &)>;
+    FrameCache() = delete;
+    explicit FrameCache(size_t numChannels, size_t framesPerSet = 1, size_t capacity = 4);
+    FrameCache(const FrameCache &) = delete;
+    FrameCache &operator=(const FrameCache &) = delete;
+    // Waits for a preparation already running, and drops any still queued
+    ~FrameCache() noexcept;
+    // The cached set for log2Size, or a new one planned with effort with window applied to every frame, on the calling
+    // thread. A cached set's windows are left as they are, as its frames may be in use.
+    std::shared_ptr<FrameSet> acquire(size_t log2Size, fftw::WindowFunction window,
+                                      fftw::PlannerEffort effort = fftw::PlannerEffort::Estimate);
+    // acquire() in the background, followed by then if given. The caller mustn't touch the set's frames until it's
+    // ready, and then must be the only one touching them.
+    std::shared_ptr<PendingFrameSet> prepare(size_t log2Size, fftw::WindowFunction window, Prepare then = {});
+    bool contains(size_t log2Size) const;
+    FrameCacheMetrics metrics() const;
+
+  private:
+    struct Job {
+        std::shared_ptr<PendingFrameSet> pending;
+        fftw::WindowFunction window;
+        Prepare then;
+    };
+    void runJobs() noexcept;
+    size_t numChannels_;
+    size_t framesPerSet_;
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    // Most recently used first
+    std::vector<std::shared_ptr<FrameSet>> sets_;
+    std::deque<Job> jobs_;
+    // Whether runJobs has been posted and not yet finished
+    bool running_{false};
+    FrameCacheMetrics metrics_{};
+};
+
+} // namespace PulseView
@@ -0,0 +1,55 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "fftw_helper.h"
+#include "pulseview.h"
+
+namespace PulseView::kernels {
+
+// Frames of 2^minSpecialisedLog2Size to 2^maxSpecialisedLog2Size samples with one of specialisedChannelCounts channels
+// get kernels compiled for exactly that size and count, so every loop has a constant trip count the compiler can
+// unroll and vectorise without remainder handling. Anything else, including the largest sizes where loop overhead no
+// longer shows, gets the generic kernels, which are the same code with the size and count read at runtime.
+constexpr size_t minSpecialisedLog2Size = 8;
+constexpr size_t maxSpecialisedLog2Size = 16;
+constexpr std::array<size_t, 4> specialisedChannelCounts{1, 2, 4, 8};
+
+template <typename T> struct MinMax {
+    T min;
+    T max;
+};
+
+// Minimum and maximum of samples[0, n), n > 0
+MinMax<double> minMax(const double *samples, size_t n) noexcept;
+MinMax<float> minMax(const float *samples, size_t n) noexcept;
+
+// Rows are laid out as in BasicFFTWHelper: channel c's size samples start at c * size and every row of samples or bins
+// starts on a cache line. The size and channel count passed in are ignored by specialised kernels.
+template <typename T> struct FrameKernels {
+    using Complex = fftw::BasicFFTWComplex<T>;
+    // Converts size interleaved frames of numChannels channels, writing channel c to out[c][0, size)
+    void (*load)(const S16NESample *interleaved, size_t size, size_t numChannels, T *const *out);
+    // One row of samples multiplied by size coefficients
+    void (*window)(const T *samples, const T *coefficients, size_t size, T *out);
+    // The magnitude or power of size / 2 + 1 bins
+    void (*magnitude)(const Complex *bins, size_t size, T *out);
+    void (*power)(const Complex *bins, size_t size, T *out);
+    // The min and max of each of numColumns equal slices of one row, as BasicPCMChunk::minMaxEnvelope
+    void (*envelope)(const T *samples, size_t size, size_t numColumns, T *mins, T *maxs);
+    bool specialised;
+};
+
+// Looked up in a table built at compile time, so callers do this once per frame size rather than per call
+template <typename T> const FrameKernels<T> &frameKernels(size_t log2Size, size_t numChannels) noexcept;
+
+extern template const FrameKernels<double> &frameKernels(size_t log2Size, size_t numChannels) noexcept;
+extern template const FrameKernels<float> &frameKernels(size_t log2Size, size_t numChannels) noexcept;
+
+} // namespace PulseView::kernels
@@ -0,0 +1,71 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "latency_stats.h"
+#include "render_model.h"
+
+namespace PulseView {
+
+struct PacingMetrics {
+    // Frames drawn and displayed
+    uint64_t framesRendered;
+    // Frames that found no new audio and nothing else to redraw, so neither drew nor displayed anything
+    uint64_t framesSkipped;
+    // Rendered frames whose work took longer than the period
+    uint64_t overBudget;
+    // Times a frame started more than a whole period late, after which the schedule restarts from then
+    uint64_t missedDeadlines;
+    uint64_t degradations;
+    uint64_t recoveries;
+    // Rendered frames at each RenderQuality
+    std::array<uint64_t, numRenderQualities> framesAtQuality;
+};
+
+// Schedules frames a fixed period apart and picks the RenderQuality they're drawn at. After overBudgetToDegrade
+// consecutive frames whose work (everything but presenting) overran the period it drops a level, and after
+// underBudgetToRecover consecutive frames using at most half the period it climbs one back.
+class FramePacer {
+  public:
+    static constexpr unsigned overBudgetToDegrade = 3;
+    static constexpr unsigned underBudgetToRecover = 120;
+    explicit FramePacer(uint64_t periodMicros = 1000000 / 60) noexcept : periodMicros_{periodMicros} {}
+    // With sleep false something else already blocks each presented frame until it's due, e.g. vsync, so
+    // waitForNextFrame only sleeps after a skipped frame
+    void setPeriod(uint64_t periodMicros, bool sleep = true) noexcept;
+    uint64_t periodMicros() const noexcept { return periodMicros_; }
+    // Non-adaptive pacing keeps the quality at Full
+    void setAdaptive(bool adaptive) noexcept;
+    // The lowest quality degradation may reach, e.g. Decimated when nothing can analyse smaller frames
+    void setLowestQuality(RenderQuality quality) noexcept;
+    // Blocks until the next frame is due
+    void waitForNextFrame();
+    void frameSkipped() noexcept;
+    // Records a frame whose work took workMicros, returns true if that changed quality()
+    bool frameRendered(uint64_t workMicros) noexcept;
+    RenderQuality quality() const noexcept { return quality_; }
+    const PacingMetrics &metrics() const noexcept { return metrics_; }
+
+  private:
+    void setQuality(RenderQuality quality) noexcept;
+    uint64_t periodMicros_;
+    bool sleep_{true};
+    bool adaptive_{true};
+    bool lastSkipped_{false};
+    RenderQuality quality_{RenderQuality::Full};
+    RenderQuality lowestQuality_{RenderQuality::SmallerFFT};
+    unsigned overBudgetRun_{0};
+    unsigned underBudgetRun_{0};
+    // Unset until the first frame
+    LatencyClock::time_point deadline_{};
+    PacingMetrics metrics_{};
+};
+
+} // namespace PulseView
@@ -0,0 +1,51 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <string>
+
+#include <SFML/Graphics.hpp>
+
+#include "pulseview.h"
+
+namespace PulseView {
+
+// Destination for frames rendered offscreen
+class FrameSink {
+  public:
+    virtual ~FrameSink() = default;
+    virtual void write(const sf::Image &image) = 0;
+};
+
+// Writes each frame to <directory>/frame-NNNNNN.png
+class PNGSequenceSink : public FrameSink {
+  public:
+    PNGSequenceSink() = delete;
+    explicit PNGSequenceSink(std::string directory);
+    void write(const sf::Image &image);
+
+  private:
+    std::string directory_;
+    size_t frameIndex_{0};
+};
+
+// Writes the RGBA pixels of each frame back to back, "-" writes to stdout. The stream can be fed straight to an
+// encoder, e.g. ffmpeg -f rawvideo -pix_fmt rgba -s WxH -r FPS -i -
+class RawVideoSink : public FrameSink {
+  public:
+    RawVideoSink() = delete;
+    explicit RawVideoSink(const std::string &path);
+    RawVideoSink(const RawVideoSink &) = delete;
+    RawVideoSink &operator=(const RawVideoSink &) = delete;
+    ~RawVideoSink() noexcept;
+    void write(const sf::Image &image);
+
+  private:
+    int fd_;
+    bool ownsFD_;
+};
+
+} // namespace PulseView
@@ -0,0 +1,71 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "capture_thread.h"
+#include "fftw_helper.h"
+#include "frame_cache.h"
+#include "pulseview.h"
+#include "render_model.h"
+#include "signal_history.h"
+
+namespace PulseView {
+
+// Picks the frame captured audio is analysed into as the FFT size changes, without a visible hitch. The frame passed
+// to the constructor is used at its own size; other sizes come from a FrameCache, which plans them and seeds them with
+// the newest audio in the background while the current frame keeps being analysed. The newest audio comes from the
+// history when there is one, and otherwise from a SignalHistory of its own just large enough for the largest frame,
+// so a new frame never starts out silent.
+class FrameSwitcher {
+  public:
+    FrameSwitcher() = delete;
+    // Has capture append everything it pops to the switcher's own history. frame must outlive this.
+    FrameSwitcher(CaptureThread &capture, Frame &frame);
+    FrameSwitcher(const FrameSwitcher &) = delete;
+    FrameSwitcher &operator=(const FrameSwitcher &) = delete;
+    // Seeds from history from then on instead, and has capture append to it. history must outlive this.
+    void setHistory(SignalHistory *history);
+    // Whichever history frames are seeded from
+    const SignalHistory &recentAudio() const noexcept { return *history_; }
+    // Moves on to a frame of log2Size once one is ready, returns whether current() changed
+    bool update(size_t log2Size);
+    Frame &current() noexcept { return set_ ? *set_->frames.front() : frame_; }
+    // Applies window to the current frame and any frame switched to from then on
+    void setWindowFunction(fftw::WindowFunction window);
+    FrameCacheMetrics metrics() const { return frames_.metrics(); }
+
+  private:
+    // Has the cache prepare a frame of log2Size, seeded with the newest audio
+    void prepare(size_t log2Size);
+    // Fills frame with the newest audio, as a frame switched to missed everything captured while another was analysed
+    void seed(Frame &frame);
+    // Slides in whatever the history gained since seededAt, while the previous frame was still being analysed
+    void catchUp(Frame &frame, uint64_t seededAt);
+    CaptureThread &capture_;
+    Frame &frame_;
+    FrameCache frames_;
+    fftw::WindowFunction windowFunction_;
+    // Null once setHistory has been called
+    std::unique_ptr<SignalHistory> ownHistory_;
+    SignalHistory *history_;
+    // Where the current frame comes from, null for frame_, and the set being prepared to replace it
+    std::shared_ptr<FrameSet> set_;
+    std::shared_ptr<PendingFrameSet> pending_;
+    // The history's framesWritten() when the pending set's seed was copied
+    uint64_t pendingSeededAt_{0};
+    // Which frame was current last, to tell when it changes. Sets are told apart by generation rather than address,
+    // which a set allocated after another was evicted could reuse.
+    size_t currentLog2Size_{0};
+    uint64_t currentGeneration_{0};
+    std::vector<S16NESample> seed_;
+};
+
+} // namespace PulseView
@@ -0,0 +1,47 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <array>
+#include <cstdio>
+#include <string>
+
+#include "latency_stats.h"
+
+namespace PulseView {
+
+// What one pass of the render loop spent in each stage. Only the render thread's stages have a start time.
+struct FrameTiming {
+    uint64_t index;
+    std::array<LatencyClock::time_point, numStages> start;
+    std::array<uint64_t, numStages> micros;
+    // False when the frame had no new audio, so the latencies tied to audio weren't measured
+    bool hasAudio;
+};
+
+// CSV writes one row of stage durations per frame. ChromeTrace writes trace event JSON that chrome://tracing and
+// Perfetto can open, with the render stages as spans and the latencies as counters.
+enum class TraceFormat { CSV, ChromeTrace };
+
+// Streams per-frame timings to a file as they are recorded
+class FrameTrace {
+  public:
+    FrameTrace() = delete;
+    FrameTrace(const std::string &path, TraceFormat format);
+    FrameTrace(const FrameTrace &) = delete;
+    FrameTrace &operator=(const FrameTrace &) = delete;
+    ~FrameTrace() noexcept;
+    void record(const FrameTiming &timing);
+
+  private:
+    uint64_t sinceOpened(LatencyClock::time_point t) const noexcept;
+    FILE *file_;
+    TraceFormat format_;
+    LatencyClock::time_point opened_;
+    bool first_{true};
+};
+
+} // namespace PulseView
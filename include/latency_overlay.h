@@ -0,0 +1,46 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include <SFML/Graphics.hpp>
+
+#include "latency_stats.h"
+
+namespace PulseView {
+
+// Draws the p50, p99 and max of every stage as nested bars over the frame, with a marker at the frame budget. Labels
+// are added when a font has been loaded.
+class LatencyOverlay {
+  public:
+    void setFrameBudget(uint64_t micros) noexcept { frameBudgetMicros_ = micros; }
+    bool loadFont(const std::string &path);
+    // Loads path the first time the overlay is drawn, so it's neither read nor warned about unless it's shown
+    void setFontPath(std::string path) {
+        fontPath_ = std::move(path);
+        fontTried_ = false;
+    }
+    void draw(sf::RenderTarget &target, const LatencyStats &stats);
+
+  private:
+    void addBar(size_t row, float left, float width, sf::Color color);
+    uint64_t frameBudgetMicros_{16667};
+    sf::VertexArray quads_{sf::Quads};
+    sf::Font font_;
+    bool haveFont_{false};
+    std::string fontPath_;
+    bool fontTried_{true};
+    sf::Text label_;
+    static inline const sf::Color panelColor{0, 0, 0, 160};
+    static inline const sf::Color maxColor{255, 80, 80, 200};
+    static inline const sf::Color p99Color{255, 200, 60, 220};
+    static inline const sf::Color p50Color{120, 230, 120, 255};
+    static inline const sf::Color budgetColor{255, 255, 255, 255};
+};
+
+} // namespace PulseView
@@ -0,0 +1,62 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace PulseView {
+
+using LatencyClock = std::chrono::steady_clock;
+
+inline uint64_t toMicros(LatencyClock::duration d) noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+// SourceRead is timed on the capture thread, SourceLatency is what the audio server reports for the stream, and
+// AudioToPhoton runs from the audio server capturing the newest drawn sample to the frame being displayed
+enum class Stage { SourceRead, SourceLatency, Capture, Events, Draw, Display, Frame, AudioToPhoton };
+constexpr size_t numStages = 8;
+
+const char *stageName(Stage stage) noexcept;
+
+// Log-linear histogram of microsecond durations, accurate to within 25%. Recording is wait-free and safe from any
+// thread, reading while another thread records gives a slightly stale but usable result.
+class LatencyHistogram {
+  public:
+    void record(uint64_t micros) noexcept;
+    uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const noexcept { return max_.load(std::memory_order_relaxed); }
+    // Upper bound of the bucket holding the value at fraction p of the recorded values, 0 if nothing was recorded
+    uint64_t percentile(double p) const noexcept;
+
+  private:
+    // Each power of two is split into this many linear sub-buckets
+    static constexpr unsigned subBucketBits = 2;
+    static constexpr size_t subBuckets = 1 << subBucketBits;
+    static constexpr size_t numBuckets = subBuckets + (64 - subBucketBits) * subBuckets;
+    static size_t bucketIndex(uint64_t micros) noexcept;
+    static uint64_t bucketUpperBound(size_t index) noexcept;
+    std::array<std::atomic<uint64_t>, numBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+class LatencyStats {
+  public:
+    LatencyHistogram &operator[](Stage stage) noexcept { return histograms_[static_cast<size_t>(stage)]; }
+    const LatencyHistogram &operator[](Stage stage) const noexcept {
+        return histograms_[static_cast<size_t>(stage)];
+    }
+
+  private:
+    std::array<LatencyHistogram, numStages> histograms_;
+};
+
+} // namespace PulseView
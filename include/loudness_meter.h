@@ -0,0 +1,117 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pulseview.h"
+
+namespace PulseView {
+
+// Linear amplitudes relative to full scale
+struct ChannelLevels {
+    // Over the last 400 ms
+    double peak;
+    double truePeak;
+    double rms;
+    // Since the last reset
+    double maxTruePeak;
+};
+
+// In LUFS, -infinity until there's been enough audio
+struct Loudness {
+    double momentary;
+    double shortTerm;
+    double integrated;
+};
+
+double toDecibels(double amplitude) noexcept;
+
+// Sample and true peak, RMS and EBU R128 (ITU-R BS.1770-4) loudness, updated incrementally from every sample fed to
+// it. Each channel is K-weighted by a pair of biquads whose state carries over between calls, and everything is
+// summed in 100 ms steps. Momentary and short-term loudness average the last 4 and 30 steps, and every step completes
+// an overlapping 400 ms gating block that's counted in a histogram of 0.1 LU bins, so integrated loudness takes fixed
+// memory however long it runs. True peak is measured on a copy oversampled 4 times (2 times from 96 kHz, not at all
+// from 192 kHz) by a polyphase FIR. 6 channels are weighted as 5.1 in PulseAudio's order, skipping the LFE and
+// weighting the surrounds 1.41, and every other layout weights channels equally.
+class LoudnessMeter {
+  public:
+    static constexpr size_t stepsPerSecond = 10;
+    static constexpr size_t momentarySteps = 4;
+    static constexpr size_t shortTermSteps = 30;
+    LoudnessMeter() = delete;
+    LoudnessMeter(size_t numChannels, size_t sampleRate);
+    // Feeds numFrames frames of every channel c from channels[c], normalised to [-1, 1]
+    template <typename T> void process(const T *const *channels, size_t numFrames) noexcept;
+    // Feeds numFrames interleaved frames, normalising them on the way
+    void processInterleaved(const S16NESample *interleaved, size_t numFrames) noexcept;
+    size_t numChannels() const noexcept { return channels_.size(); }
+    const ChannelLevels &levels(size_t channel) const noexcept { return channels_[channel].levels; }
+    Loudness loudness() const noexcept { return loudness_; }
+    // Restarts integrated loudness and the maximum true peaks
+    void reset() noexcept;
+
+  private:
+    // Direct form II transposed
+    struct Biquad {
+        double b0, b1, b2, a1, a2;
+        double z1{0.}, z2{0.};
+        double process(double x) noexcept {
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+    struct Channel {
+        Biquad shelf;
+        Biquad highPass;
+        double weight;
+        // The newest inputs, written twice tapsPerPhase apart so the taps always read one contiguous run
+        std::vector<double> recent;
+        size_t recentPos{0};
+        // Of the step being filled
+        double stepWeighted{0.};
+        double stepSquares{0.};
+        double stepPeak{0.};
+        double stepTruePeak{0.};
+        // Of the last momentarySteps steps
+        std::array<double, momentarySteps> squares{};
+        std::array<double, momentarySteps> peaks{};
+        std::array<double, momentarySteps> truePeaks{};
+        ChannelLevels levels{};
+    };
+    static constexpr double histogramFloor = -70.;
+    static constexpr double histogramBinWidth = .1;
+    static constexpr size_t numHistogramBins = 1000;
+    // Of the oversampling filter, 48 taps in all at 4 times
+    static constexpr size_t tapsPerPhase = 12;
+    template <typename Read> void feed(size_t numFrames, Read read) noexcept;
+    void add(Channel &channel, double x) noexcept;
+    void finishStep() noexcept;
+    double integrated() const noexcept;
+    size_t stepFrames_;
+    size_t oversampling_;
+    // oversampling_ phases of tapsPerPhase taps, newest input first
+    std::vector<double> taps_;
+    std::vector<Channel> channels_;
+    size_t framesInStep_{0};
+    uint64_t numSteps_{0};
+    // Channel weighted mean square of the K-weighted signal in each of the last shortTermSteps steps
+    std::array<double, shortTermSteps> stepEnergies_{};
+    std::array<uint64_t, numHistogramBins> histogram_{};
+    // The mean square each bin stands for
+    std::array<double, numHistogramBins> binEnergies_{};
+    Loudness loudness_;
+};
+
+extern template void LoudnessMeter::process(const double *const *channels, size_t numFrames) noexcept;
+extern template void LoudnessMeter::process(const float *const *channels, size_t numFrames) noexcept;
+
+} // namespace PulseView
@@ -4,23 +4,66 @@
 //
 
 #pragma once
+#include <atomic>
+#include <string>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
 #include "pulseview.h"
 #include "render_model.h"
+#include "sample_conversion.h"
 #include "source.h"
 
 namespace PulseView::AudioSource {
 
+struct PCMStreamConfig {
+    // Run with /bin/sh -c, reading its standard output. Empty to read fd instead.
+    std::string command;
+    // Only used without a command. It's switched to non-blocking but left open on destruction.
+    int fd{STDIN_FILENO};
+    conversion::SampleFormat format{conversion::SampleFormat::S16NE};
+    size_t sampleRate{48000};
+    size_t numChannels{2};
+};
+
+// Reads interleaved PCM from the output of a command (e.g. pacat, arecord, sox or ffmpeg) or an already open file
+// descriptor. The descriptor is non-blocking and reads wait in epoll, so a stalled or exited producer is noticed
+// instead of hanging in read(), and interrupt() wakes them through an eventfd in the same epoll set. Other formats
+// are converted to S16NE, every channel is kept.
 class PCMProcessSource : public Source {
   public:
-    PCMProcessSource();
-    ~PCMProcessSource();
+    PCMProcessSource() = delete;
+    explicit PCMProcessSource(PCMStreamConfig config);
+    PCMProcessSource(const PCMProcessSource &) = delete;
+    PCMProcessSource &operator=(const PCMProcessSource &) = delete;
+    ~PCMProcessSource() noexcept;
     void populateFrame(PulseView::Frame &frame);
+    void read(S16NESample *buffer, size_t numFrames);
+    size_t numChannels() const noexcept { return config_.numChannels; }
+    size_t sampleRate() const noexcept { return config_.sampleRate; }
+    void interrupt() noexcept;
+    // The pacat command the original hard-coded source ran
+    static PCMStreamConfig pacat(size_t sampleRate);
 
   private:
-    std::string processCMDLine_;
-    static const size_t numChannels_ = 2;
-    int processFD_;
-    pid_t processPID_;
+    void spawn();
+    void setUpFD();
+    void readBytes(void *out, size_t numBytes);
+    void release() noexcept;
+    PCMStreamConfig config_;
+    // Reused by populateFrame, so it only allocates when the frame width grows
+    fftw::FFTWVector<S16NESample> buffer_;
+    // Raw input awaiting conversion, unused when the input is already S16NE
+    std::vector<unsigned char> raw_;
+    int processFD_{-1};
+    pid_t processPID_{-1};
+    int epollFD_{-1};
+    // Readable once interrupted, waking every epoll_wait from then on
+    int wakeFD_{-1};
+    std::atomic<bool> interrupted_{false};
+    // Regular files can't be polled, and never block anyway
+    bool pollable_{true};
 };
 
 } // namespace PulseView::AudioSource
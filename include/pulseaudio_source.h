@@ -4,6 +4,8 @@
 //
 
 #pragma once
+#include <string>
+
 #include "pulseview.h"
 #include "render_model.h"
 #include "source.h"
@@ -15,17 +17,25 @@ namespace PulseView::AudioSource {
 class PulseAudioSource : public Source {
   public:
     PulseAudioSource() = delete;
-    PulseAudioSource(size_t audioRate);
+    // fragmentFrames asks the server to deliver audio in fragments of that many frames, 0 leaves it to the server.
+    // device is the name of a source or monitor, empty for the server's default.
+    PulseAudioSource(size_t audioRate, size_t fragmentFrames = 0, const std::string &device = "",
+                     size_t numChannels = 2);
     PulseAudioSource(const PulseAudioSource &) = delete;
     PulseAudioSource(PulseAudioSource &&);
     PulseAudioSource &operator=(const PulseAudioSource &) = delete;
     PulseAudioSource &operator=(PulseAudioSource &&);
     ~PulseAudioSource() noexcept;
     void populateFrame(PulseView::Frame &frame);
+    void read(S16NESample *buffer, size_t numFrames);
+    size_t numChannels() const noexcept { return numChannels_; }
+    uint64_t latencyMicros();
 
   private:
     pa_simple *simple_;
-    static const size_t numChannels_ = 2;
+    size_t numChannels_;
+    // Reused by populateFrame, so it only allocates when the frame width grows
+    fftw::FFTWVector<S16NESample> buffer_;
 };
 
 } // namespace PulseView::AudioSource
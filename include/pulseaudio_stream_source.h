@@ -0,0 +1,55 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <string>
+
+#include "pulseview.h"
+#include "render_model.h"
+#include "source.h"
+
+extern "C" struct pa_threaded_mainloop;
+extern "C" struct pa_context;
+extern "C" struct pa_stream;
+
+namespace PulseView::AudioSource {
+
+// Records through PulseAudio's asynchronous API. The stream asks the server for fragments of fragmentFrames frames
+// and lets it adjust its latency to match, and reads copy straight out of the server's buffers with pa_stream_peek.
+class PulseAudioStreamSource : public Source {
+  public:
+    PulseAudioStreamSource() = delete;
+    // device is the name of a source or monitor (see pactl list short sources), empty for the server's default
+    PulseAudioStreamSource(size_t audioRate, size_t fragmentFrames, const std::string &device = "",
+                           size_t numChannels = 2);
+    PulseAudioStreamSource(const PulseAudioStreamSource &) = delete;
+    PulseAudioStreamSource &operator=(const PulseAudioStreamSource &) = delete;
+    ~PulseAudioStreamSource() noexcept;
+    void populateFrame(PulseView::Frame &frame);
+    void read(S16NESample *buffer, size_t numFrames);
+    size_t numChannels() const noexcept { return numChannels_; }
+    uint64_t latencyMicros();
+    void interrupt() noexcept;
+
+  private:
+    static void onContextState(pa_context *context, void *self);
+    static void onStreamState(pa_stream *stream, void *self);
+    static void onReadable(pa_stream *stream, size_t numBytes, void *self);
+    [[noreturn]] void failLocked(const std::string &err);
+    void close() noexcept;
+    size_t numChannels_;
+    pa_threaded_mainloop *mainloop_{nullptr};
+    pa_context *context_{nullptr};
+    pa_stream *stream_{nullptr};
+    // Bytes of the fragment at the front of the stream already handed out, it's dropped once fully consumed
+    size_t peekOffset_{0};
+    // Only touched with the mainloop locked
+    bool interrupted_{false};
+    // Reused by populateFrame, so it only allocates when the frame width grows
+    fftw::FFTWVector<S16NESample> buffer_;
+};
+
+} // namespace PulseView::AudioSource
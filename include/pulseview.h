@@ -4,6 +4,8 @@
 //
 
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #define die(msg) throw std::runtime_error(__FILE__ ":" + std::to_string(__LINE__) + ": " msg)
@@ -13,4 +15,30 @@ namespace PulseView {
 
 void fail_errno(std::string err, int err_no = errno);
 
+// Raw interleaved samples as sources deliver them
+using S16NESample = int16_t;
+
+// Precision of the whole sample pipeline, from conversion through the FFT to drawing
+#ifdef PULSEVIEW_SINGLE_PRECISION
+using Sample = float;
+#else
+using Sample = double;
+#endif
+
+// Non-owning view of a contiguous run of elements, used where std::span would be in C++20
+template <typename T> class Span {
+  public:
+    constexpr Span() noexcept = default;
+    constexpr Span(T *data, size_t size) noexcept : data_{data}, size_{size} {}
+    constexpr T *data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr T &operator[](size_t i) const noexcept { return data_[i]; }
+    constexpr T *begin() const noexcept { return data_; }
+    constexpr T *end() const noexcept { return data_ + size_; }
+
+  private:
+    T *data_{nullptr};
+    size_t size_{0};
+};
+
 } // namespace PulseView
@@ -0,0 +1,82 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pulseview.h"
+#include "spsc_ring.h"
+
+namespace PulseView {
+
+enum class RecordFormat { WAV, Raw };
+
+struct RecorderMetrics {
+    // Frames written to the recording
+    uint64_t framesWritten;
+    // Blocks pushed while the queue was too full to take them, and the frames in them
+    uint64_t droppedBlocks;
+    uint64_t droppedFrames;
+    uint64_t snapshotsSaved;
+    // Set once writing the recording failed, after which it's no longer written
+    bool failed;
+};
+
+// Writes captured audio to disk on a background thread. push() only copies into a bounded queue, and whatever doesn't
+// fit is dropped and counted, so a slow disk never stalls the thread pushing. The writer thread streams the queue to
+// the recording in large block aligned writes, bypassing the page cache with O_DIRECT where the filesystem supports
+// it, and also keeps the newest preTriggerFrames frames in memory for saveSnapshot().
+class Recorder {
+  public:
+    Recorder() = delete;
+    // Records everything pushed to path unless that's empty, keeping a pre-trigger ring if preTriggerFrames isn't 0
+    Recorder(size_t numChannels, size_t sampleRate, RecordFormat format, const std::string &path,
+             size_t preTriggerFrames = 0);
+    Recorder(const Recorder &) = delete;
+    Recorder &operator=(const Recorder &) = delete;
+    // Writes out whatever is still queued and finishes the recording
+    ~Recorder() noexcept;
+    // For exactly one thread, normally the capture thread. Never blocks or allocates.
+    void push(const S16NESample *interleaved, size_t numFrames) noexcept;
+    // Has the writer thread save the pre-trigger ring, everything pushed up to now, to path in the recording's format
+    void saveSnapshot(const std::string &path);
+    size_t numChannels() const noexcept { return numChannels_; }
+    RecordFormat format() const noexcept { return format_; }
+    RecorderMetrics metrics() const noexcept;
+
+  private:
+    void run() noexcept;
+    void consume(const S16NESample *interleaved, size_t numSamples);
+    void saveSnapshots();
+    size_t numChannels_;
+    size_t sampleRate_;
+    RecordFormat format_;
+    SPSCRing<S16NESample> queue_;
+    // Everything below, bar the counters and snapshotRequests_, belongs to the writer thread
+    class AudioFileWriter;
+    std::unique_ptr<AudioFileWriter> recording_;
+    std::vector<S16NESample> preTrigger_;
+    size_t preTriggerNext_{0};
+    bool preTriggerFull_{false};
+    std::mutex snapshotMutex_;
+    std::vector<std::string> snapshotRequests_;
+    std::atomic<uint64_t> framesWritten_{0};
+    std::atomic<uint64_t> droppedBlocks_{0};
+    std::atomic<uint64_t> droppedFrames_{0};
+    std::atomic<uint64_t> snapshotsSaved_{0};
+    std::atomic<bool> failed_{false};
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+} // namespace PulseView
@@ -5,63 +5,228 @@
 
 #include <cassert>
 #include <complex>
+#include <optional>
+#include <vector>
 
 #include <SFML/Graphics.hpp>
 #include <fftw3.h>
 
 #include <fftw_helper.h>
+#include <loudness_meter.h>
 #include <pulseview.h>
+#include <signal_history.h>
+#include <spectrogram.h>
+#include <spectrum_layout.h>
 
 #pragma once
 
 namespace PulseView {
 
-enum class AudioChannel { Left = 0, Right };
-extern AudioChannel AudioChannels[2];
-
-using S16NESample = int16_t;
 using Complex = std::complex<double>;
 
-struct PCMChunk {
-    void reserveSize(size_t log2NumSamples);
+template <typename T> struct BasicPCMChunk {
+    // samples and dft are views into storage owned by the enclosing Frame, as are the kernels picked for its size
+    void bind(T *sampleStorage, T *dftStorage, size_t log2NumSamples, const kernels::FrameKernels<T> *frameKernels);
     void clear();
-    double minInRange(size_t s, size_t e, size_t numSteps) const;
-    double maxInRange(size_t s, size_t e, size_t numSteps) const;
-    void calculateDFT(fftw::FFTWHelper &helper);
+    T minInRange(size_t s, size_t e, size_t numSteps) const;
+    T maxInRange(size_t s, size_t e, size_t numSteps) const;
+    // Writes the min and max of each of numColumns equal slices of samples in a single pass
+    void minMaxEnvelope(size_t numColumns, T *mins, T *maxs) const;
     double getDftValueOverRange(size_t s, size_t e, size_t numSteps) const;
-    std::vector<double> samples;
-    std::vector<double> dft;
+    Span<T> samples;
+    Span<T> dft;
     size_t log2Size;
+    const kernels::FrameKernels<T> *kernels{nullptr};
 };
 
-struct Frame {
-    Frame() = delete;
-    Frame(size_t logNumSamples);
+// The range of frame sizes, as powers of two
+constexpr size_t minLog2FrameSize = 8;
+constexpr size_t maxLog2FrameSize = 20;
+
+// Holds numChannels channels as structure of arrays: every channel's samples sit in one allocation (the FFT's input)
+// and every channel's spectrum in another, each channel starting on its own cache line
+template <typename T> struct BasicFrame {
+    using Chunk = BasicPCMChunk<T>;
+    BasicFrame() = delete;
+    BasicFrame(size_t logNumSamples, size_t numChannels = 2,
+               fftw::PlannerEffort plannerEffort = fftw::PlannerEffort::Measure);
+    BasicFrame(const BasicFrame &) = delete;
+    BasicFrame &operator=(const BasicFrame &) = delete;
     void clear();
+    // Converts numSamples interleaved frames of srcChannels (which must equal numChannels) channels into the
+    // per-channel sample buffers
+    void loadInterleaved(const S16NESample *interleaved, size_t srcChannels);
+    // Slides the window along by numFrames interleaved frames, only converting the new ones. Every frame is also fed to
+    // meter if there is one, in blocks small enough that each is still in cache from being converted.
+    void advance(const S16NESample *interleaved, size_t numFrames, size_t srcChannels, LoudnessMeter *meter = nullptr);
     void finalize();
-    PCMChunk &getChunk(AudioChannel channel) noexcept;
-    const PCMChunk &getChunk(AudioChannel channel) const noexcept;
+    void setWindow(fftw::WindowFunction window) { fftw.setWindow(window); }
+    Chunk &getChunk(size_t channel) noexcept { return chunks[channel]; }
+    const Chunk &getChunk(size_t channel) const noexcept { return chunks[channel]; }
+    size_t numChannels;
     size_t log2Size;
     size_t numSamples;
-    PCMChunk leftChunk;
-    PCMChunk rightChunk;
-    fftw::FFTWHelper fftw;
+    fftw::BasicFFTWHelper<T> fftw;
+    // Elements between the starts of consecutive channels in spectra
+    size_t dftStride;
+    fftw::FFTWVector<T> spectra;
+    std::vector<Chunk> chunks;
+
+  private:
+    void convertInterleaved(const S16NESample *interleaved, size_t numFrames, size_t srcChannels, size_t offset,
+                            LoudnessMeter *meter);
+    // Scratch for the per-channel output pointers conversion takes
+    std::vector<T *> convertOut_;
+};
+
+extern template struct BasicPCMChunk<double>;
+extern template struct BasicPCMChunk<float>;
+extern template struct BasicFrame<double>;
+extern template struct BasicFrame<float>;
+
+// The precision the application runs in, see Sample
+using PCMChunk = BasicPCMChunk<Sample>;
+using Frame = BasicFrame<Sample>;
+
+// Full draws a vertex per sample, Envelope draws the min/max of each pixel column, Auto picks Envelope whenever there
+// are more samples than columns. Frames larger than maxFullWaveformSamples are always drawn as an envelope.
+enum class WaveformMode { Auto, Full, Envelope };
+constexpr size_t maxFullWaveformSamples = 1 << 14;
+
+// The steps drawing is degraded in when frames run over budget, each cheaper than the last and keeping the cuts of
+// those before it. SmallerFFT is up to whoever analyses the frames, RenderModel draws it like Decimated.
+enum class RenderQuality { Full, FewerBars, Decimated, SmallerFFT };
+constexpr size_t numRenderQualities = 4;
+
+const char *renderQualityName(RenderQuality quality) noexcept;
+
+// The spanFrames frames of a SignalHistory before endFrame, or before the newest frame while live
+struct HistoryView {
+    uint64_t spanFrames;
+    uint64_t endFrame;
+    bool live;
 };
 
+// Bars redraws the instantaneous spectrum of each channel every frame, Spectrogram scrolls a history of the spectrum
+// averaged over every channel behind the waveforms
+enum class SpectrumView { Bars, Spectrogram };
+
+// Channels are drawn in lanes: stereo keeps the mirrored layout with the left spectrum hanging from the top and the
+// right one rising from the bottom over the full height, any other count stacks one lane per channel. Every bar and
+// waveform is a triangle in one list, streamed through a single vertex buffer and drawn with a single call. Triangles
+// that only move with the layout are uploaded once and skipped by the per-frame uploads until it changes.
 class RenderModel {
   public:
-    RenderModel(sf::RenderWindow &window);
+    RenderModel(sf::RenderTarget &target);
     void resize(size_t width, size_t height);
-    void drawFrame(const Frame &frame);
+    void setWaveformMode(WaveformMode mode) noexcept;
+    // numBars of 0 draws one bar per pixel column, sampleRate is only used by the mel scale
+    void setSpectrum(SpectrumScale scale, size_t numBars, size_t sampleRate) noexcept;
+    void setSpectrumView(SpectrumView view) noexcept { spectrumView_ = view; }
+    // 0 draws one bar per pixel column
+    void setNumBars(size_t numBars) noexcept { numBars_ = numBars; }
+    size_t numBars() const noexcept { return numBars_; }
+    void setQuality(RenderQuality quality) noexcept { quality_ = quality; }
+    // The spectrogram keeps historyColumns frames, with a row per bar (or per pixel row when numBars is 0)
+    void setSpectrogram(size_t historyColumns, Colormap colormap) noexcept;
+    // Unless view is live and spans exactly the frame, the waveforms show the envelope of view instead of the frame,
+    // summarised from history's pyramid in time proportional to the width. history may be null to always show the
+    // frame, and must otherwise outlive its use here and hold as many channels as the frames drawn.
+    void showHistory(const SignalHistory *history, const HistoryView &view) noexcept;
+    // Draws meter's levels and loudness in a panel on the right edge over everything else, or nothing when null.
+    // meter must otherwise outlive its use here.
+    void showMeters(const LoudnessMeter *meter) noexcept { meter_ = meter; }
+    // Fills the vertex arrays for frame at the given size without touching the render target. Once the sizes involved
+    // stop changing this reuses every buffer it owns and doesn't allocate.
+    void buildGeometry(const Frame &frame, unsigned width, unsigned height);
+    // newAudio is false when frame was already drawn, so the spectrogram doesn't scroll without new audio
+    void drawFrame(const Frame &frame, bool newAudio = true);
+    // Vertices are streamed through a vertex buffer when the GL implementation supports them, which is the default.
+    // Disabling it draws them straight from client memory.
+    void useVertexBuffer(bool enable) noexcept;
+    const std::vector<sf::Vertex> &vertices() const noexcept { return vertices_; }
 
   private:
-    void prepareVertexArrays(size_t numQuadVertices, size_t numWaveVertices);
-    sf::RenderWindow &window_;
-    sf::VertexArray quadVertices_;
-    sf::VertexArray waveVertices_;
+    static constexpr size_t verticesPerBar = 6;
+    static constexpr size_t verticesPerSegment = 6;
+    static constexpr size_t verticesPerQuad = 6;
+    struct Lane {
+        float top;
+        float height;
+        bool spectrumFromTop;
+    };
+    // What the bars' x coordinates were last written for
+    struct BarPlacement {
+        unsigned width{0};
+        size_t numBars{0};
+        size_t numChannels{0};
+        bool operator==(const BarPlacement &other) const noexcept {
+            return width == other.width && numBars == other.numBars && numChannels == other.numChannels;
+        }
+    };
+    // What the meter panel was last written for
+    struct PanelPlacement {
+        unsigned width{0};
+        unsigned height{0};
+        bool operator==(const PanelPlacement &other) const noexcept {
+            return width == other.width && height == other.height;
+        }
+    };
+    enum class BufferState { Unchecked, Available, Unavailable };
+    static Lane lane(size_t channel, size_t numChannels, unsigned height) noexcept;
+    size_t numBarsFor(unsigned width) const noexcept;
+    void prepareVertices(size_t numBarVertices, size_t numWaveVertices, size_t numMeterVertices);
+    void buildSpectrum(const Frame &frame, unsigned width, unsigned height);
+    void buildSpectrogramColumn(const Frame &frame, unsigned height);
+    void buildWaveform(const PCMChunk &chunk, sf::Vertex *out, unsigned width, Lane lane);
+    void buildEnvelope(const PCMChunk &chunk, sf::Vertex *out, unsigned width, Lane lane);
+    void buildHistoryEnvelope(size_t channel, sf::Vertex *out, unsigned width, Lane lane);
+    void writeEnvelope(sf::Vertex *out, unsigned width, Lane lane);
+    void buildMeters(sf::Vertex *out, unsigned width, unsigned height);
+    void drawVertices();
+    const SpectrumLayout &spectrumLayout(size_t numBins, size_t numBars);
+    sf::RenderTarget &target_;
+    WaveformMode waveformMode_{WaveformMode::Auto};
+    bool decimate_{false};
+    SpectrumScale spectrumScale_{SpectrumScale::Quadratic};
+    size_t numBars_{128};
+    size_t sampleRate_{48000};
+    std::optional<SpectrumLayout> spectrumLayout_;
+    std::vector<double> spectrumPrefix_;
+    std::vector<double> barValues_;
+    SpectrumView spectrumView_{SpectrumView::Bars};
+    RenderQuality quality_{RenderQuality::Full};
+    size_t spectrogramHistory_{512};
+    Colormap colormap_{Colormap::Inferno};
+    Spectrogram spectrogram_;
+    // The column buildGeometry prepared for the next push
+    std::vector<double> spectrogramColumn_;
+    // The bars of every channel, then each channel's waveform or envelope, then the meters with the panel behind them
+    // first. The panel is the one range that's static, the rest changes every frame.
+    std::vector<sf::Vertex> vertices_;
+    size_t numBarVertices_{0};
+    size_t waveVerticesPerChannel_{0};
+    size_t numMeterVertices_{0};
+    BarPlacement barPlacement_;
+    PanelPlacement panelPlacement_;
+    // Whether the vertex buffer's static range is out of date, so the next draw uploads every vertex
+    bool uploadAll_{true};
+    bool preferVertexBuffer_{true};
+    BufferState bufferState_{BufferState::Unchecked};
+    sf::VertexBuffer vertexBuffer_;
+    std::vector<Sample> envelopeMin_;
+    std::vector<Sample> envelopeMax_;
+    const SignalHistory *history_{nullptr};
+    HistoryView historyView_{};
+    std::vector<SampleSummary> historySummaries_;
+    const LoudnessMeter *meter_{nullptr};
     static inline const sf::Color waveColor{255, 255, 255, 255};
     static inline const sf::Color backgroundColor{29, 116, 239, 255};
     static inline const sf::Color fftColor{0, 93, 224, 255};
+    static inline const sf::Color meterPanelColor{0, 0, 0, 160};
+    static inline const sf::Color meterColor{96, 220, 96, 255};
+    static inline const sf::Color clipColor{240, 64, 48, 255};
+    static inline const sf::Color loudnessColor{255, 196, 64, 255};
 };
 
 } // namespace PulseView
@@ -0,0 +1,36 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PulseView::conversion {
+
+enum class SampleFormat { S16NE, S32NE, F32NE };
+
+size_t bytesPerSample(SampleFormat format) noexcept;
+
+// Instruction sets the conversion kernels are built for. Every kernel produces bit-identical output, the SIMD ones
+// only speed up the common S16 mono and stereo cases and fall back to the scalar loop otherwise.
+enum class Kernel { Scalar, SSE2, AVX2 };
+
+bool kernelSupported(Kernel kernel) noexcept;
+// The fastest kernel this CPU supports, detected once
+Kernel bestKernel() noexcept;
+const char *kernelName(Kernel kernel) noexcept;
+
+// Converts numFrames frames of numChannels interleaved samples to values in [-1, 1] in a single pass, writing channel
+// c to out[c][0, numFrames). Integer formats are divided by their maximum positive value in the output precision.
+void deinterleave(const void *in, SampleFormat format, size_t numChannels, size_t numFrames, double *const *out);
+void deinterleave(const void *in, SampleFormat format, size_t numChannels, size_t numFrames, float *const *out);
+// Same as above with an explicit kernel, which must be supported
+void deinterleave(Kernel kernel, const void *in, SampleFormat format, size_t numChannels, size_t numFrames,
+                  double *const *out);
+void deinterleave(Kernel kernel, const void *in, SampleFormat format, size_t numChannels, size_t numFrames,
+                  float *const *out);
+
+} // namespace PulseView::conversion
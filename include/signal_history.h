@@ -0,0 +1,91 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pulseview.h"
+
+namespace PulseView {
+
+// Min, max and RMS of a run of samples normalised to [-1, 1], all 0 for a run with no samples
+struct SampleSummary {
+    float min;
+    float max;
+    float rms;
+};
+
+// Rolling store of the last capacityFrames frames of every channel with a pyramid of summaries over them. Level 1
+// summarises runs of fanout raw frames and each level above summarises fanout entries of the one below, all updated
+// incrementally as audio is appended, so any span can be summarised at any resolution by reading at most a few
+// entries per level for each output column rather than every sample in the span. The raw samples and every level live
+// in one mapping, anonymous or, with a backing file, paged out to that file rather than to swap.
+class SignalHistory {
+  public:
+    static constexpr size_t fanout = 8;
+    SignalHistory() = delete;
+    // capacityFrames is rounded up to a whole number of top level entries
+    SignalHistory(size_t numChannels, size_t capacityFrames, const std::string &backingPath = {});
+    SignalHistory(const SignalHistory &) = delete;
+    SignalHistory &operator=(const SignalHistory &) = delete;
+    ~SignalHistory() noexcept;
+    void append(const S16NESample *interleaved, size_t numFrames);
+    size_t numChannels() const noexcept { return numChannels_; }
+    size_t capacityFrames() const noexcept { return capacity_; }
+    size_t numLevels() const noexcept { return levels_.size(); }
+    // Frames appended so far, so the index one past the newest frame
+    uint64_t framesWritten() const noexcept { return framesWritten_; }
+    // Index of the oldest frame still held
+    uint64_t oldestFrame() const noexcept { return framesWritten_ > capacity_ ? framesWritten_ - capacity_ : 0; }
+    // Splits the spanFrames frames before end into numColumns equal slices and summarises each one. Whatever falls
+    // outside what's held (before the oldest frame, or before the first) summarises as silence.
+    void summarise(size_t channel, uint64_t end, uint64_t spanFrames, size_t numColumns, SampleSummary *out) const;
+    // Copies the newest numFrames frames out interleaved, oldest first, with silence for any before the oldest held
+    void copyNewest(S16NESample *interleaved, size_t numFrames) const noexcept;
+
+  private:
+    // Stored per entry, meanSquare rather than a sum so every level has the same range
+    struct Entry {
+        float min;
+        float max;
+        float meanSquare;
+    };
+    struct Level {
+        // Raw frames each entry covers
+        uint64_t entryFrames;
+        size_t numEntries;
+        // numEntries per channel, channel after channel, each a ring indexed by entry number
+        Entry *entries;
+    };
+    // An entry still being filled, or a range being summarised
+    struct Accumulator {
+        float min;
+        float max;
+        double sumSquares;
+        uint64_t count;
+        void clear() noexcept;
+        void add(float sample) noexcept;
+        void add(const Entry &entry, uint64_t entryFrames) noexcept;
+    };
+    const Entry &entry(size_t level, size_t channel, uint64_t index) const noexcept;
+    void accumulate(size_t channel, uint64_t begin, uint64_t end, size_t level, Accumulator &acc) const;
+    size_t numChannels_;
+    size_t capacity_;
+    void *map_{nullptr};
+    size_t mapSize_{0};
+    // capacity_ per channel, channel after channel, a ring indexed by frame number
+    S16NESample *raw_{nullptr};
+    // levels_[0] stands for the raw samples and has no entries
+    std::vector<Level> levels_;
+    // numChannels_ per level
+    std::vector<Accumulator> pending_;
+    uint64_t framesWritten_{0};
+};
+
+} // namespace PulseView
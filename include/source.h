@@ -4,6 +4,8 @@
 //
 
 #pragma once
+#include <cstdint>
+
 #include "pulseview.h"
 #include "render_model.h"
 
@@ -13,6 +15,14 @@ class Source {
   public:
     virtual ~Source() = default;
     virtual void populateFrame(PulseView::Frame &frame) = 0;
+    // Blocks until numFrames frames of interleaved samples have been written to buffer
+    virtual void read(S16NESample *buffer, size_t numFrames) = 0;
+    virtual size_t numChannels() const noexcept = 0;
+    // How long ago the audio server captured the most recently read sample, 0 when unknown
+    virtual uint64_t latencyMicros() { return 0; }
+    // Called from another thread to make a read blocked there, and every read after it, return promptly with the rest
+    // of its buffer unspecified. Sources whose reads always finish within a block of audio needn't override it.
+    virtual void interrupt() noexcept {}
 };
 
 } // namespace PulseView::AudioSource
@@ -0,0 +1,47 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+namespace PulseView {
+
+enum class Colormap { Grayscale, Heat, Inferno, Viridis };
+
+// Scrolling history of spectra kept in a ring texture, one column per analysed frame with the newest on the right.
+// Each push uploads a single column, so the cost per frame doesn't depend on how much history is shown, and drawing is
+// one textured quad whose texture coordinates start just after the newest column and wrap around the repeated texture.
+class Spectrogram {
+  public:
+    // Recreates the texture, clearing the history, when anything differs from the current configuration. numColumns
+    // is clamped to the largest texture the GL implementation supports.
+    void configure(size_t numColumns, size_t numRows, Colormap colormap);
+    bool matches(size_t numColumns, size_t numRows, Colormap colormap) const noexcept;
+    size_t numColumns() const noexcept { return numColumns_; }
+    size_t numRows() const noexcept { return numRows_; }
+    // Adds a column from numRows values in [0, 1], lowest frequency first. Values outside that are clamped.
+    void push(const double *values);
+    // Stretches the history over area
+    void draw(sf::RenderTarget &target, const sf::FloatRect &area);
+
+  private:
+    size_t numColumns_{0};
+    size_t numRows_{0};
+    // The column the next push writes to, the oldest one once the history is full
+    size_t next_{0};
+    Colormap colormap_{Colormap::Inferno};
+    std::array<sf::Color, 256> palette_;
+    // One RGBA column, top row first
+    std::vector<sf::Uint8> column_;
+    sf::Texture texture_;
+    sf::VertexArray quad_{sf::Quads, 4};
+};
+
+} // namespace PulseView
@@ -0,0 +1,39 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace PulseView {
+
+// Quadratic is the original layout, giving low frequencies more room than linear without the empty low bars log and
+// mel produce at small frame widths
+enum class SpectrumScale { Linear, Quadratic, Logarithmic, Mel };
+
+// Precomputed mapping from the bins of a spectrum to a row of bars. Building it is the only part that depends on the
+// scale, after that each frame costs one prefix sum over the bins plus O(1) per bar.
+class SpectrumLayout {
+  public:
+    SpectrumLayout() = delete;
+    SpectrumLayout(size_t numBins, size_t numBars, SpectrumScale scale, size_t sampleRate);
+    bool matches(size_t numBins, size_t numBars, SpectrumScale scale, size_t sampleRate) const noexcept;
+    size_t numBins() const noexcept { return numBins_; }
+    size_t numBars() const noexcept { return numBars_; }
+    // Writes numBars display values to bars. prefix is scratch space for numBins + 1 values.
+    template <typename T> void compute(const T *bins, double *prefix, double *bars) const noexcept;
+
+  private:
+    size_t numBins_;
+    size_t numBars_;
+    SpectrumScale scale_;
+    size_t sampleRate_;
+    // Bar i averages bins [edges_[i], max(edges_[i + 1], edges_[i] + 1)), so narrow bars repeat a bin rather than
+    // sharing one with their neighbours
+    std::vector<size_t> edges_;
+};
+
+} // namespace PulseView
@@ -0,0 +1,97 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace PulseView {
+
+// Wait-free ring buffer for exactly one producer thread (push) and one consumer thread (pop/discard). Indices grow
+// monotonically and are masked on access, so the full capacity is usable.
+template <typename T> class SPSCRing {
+    static_assert(std::is_trivially_copyable<T>::value);
+
+  public:
+    SPSCRing() = delete;
+    explicit SPSCRing(size_t minCapacity) : buffer_(roundUpToPowerOfTwo(minCapacity)), mask_{buffer_.size() - 1} {}
+    SPSCRing(const SPSCRing &) = delete;
+    SPSCRing &operator=(const SPSCRing &) = delete;
+
+    size_t capacity() const noexcept { return buffer_.size(); }
+
+    // Producer side
+    size_t writeAvailable() const noexcept {
+        return capacity() - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+    }
+
+    // Copies in as many of the count items as fit, returns the number copied
+    size_t push(const T *items, size_t count) noexcept {
+        const auto head = head_.load(std::memory_order_relaxed);
+        const auto n = std::min(count, capacity() - (head - tail_.load(std::memory_order_acquire)));
+        copyIn(head, items, n);
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side
+    size_t readAvailable() const noexcept {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+
+    // Copies out up to count items, returns the number copied
+    size_t pop(T *items, size_t count) noexcept {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        const auto n = std::min(count, head_.load(std::memory_order_acquire) - tail);
+        copyOut(tail, items, n);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Drops up to count of the oldest items, returns the number dropped
+    size_t discard(size_t count) noexcept {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        const auto n = std::min(count, head_.load(std::memory_order_acquire) - tail);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+  private:
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t rv = 1;
+        while (rv < n) {
+            rv <<= 1;
+        }
+        return rv;
+    }
+
+    void copyIn(size_t index, const T *items, size_t n) noexcept {
+        const auto start = index & mask_;
+        const auto first = std::min(n, capacity() - start);
+        std::copy(items, items + first, buffer_.data() + start);
+        std::copy(items + first, items + n, buffer_.data());
+    }
+
+    void copyOut(size_t index, T *items, size_t n) const noexcept {
+        const auto start = index & mask_;
+        const auto first = std::min(n, capacity() - start);
+        std::copy(buffer_.data() + start, buffer_.data() + start + first, items);
+        std::copy(buffer_.data(), buffer_.data() + (n - first), items + first);
+    }
+
+    static constexpr size_t cacheLineSize = 64;
+    std::vector<T> buffer_;
+    size_t mask_;
+    // Written only by the producer
+    alignas(cacheLineSize) std::atomic<size_t> head_{0};
+    // Written only by the consumer
+    alignas(cacheLineSize) std::atomic<size_t> tail_{0};
+};
+
+} // namespace PulseView
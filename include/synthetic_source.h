@@ -0,0 +1,46 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include "pulseview.h"
+#include "render_model.h"
+#include "source.h"
+
+namespace PulseView::AudioSource {
+
+enum class Signal { Sine, Chirp, Noise, Silence };
+
+// Generates a test signal instead of capturing audio. Output depends only on the constructor arguments and how much
+// has been read, so benchmarks and tests are reproducible. Reads never block.
+class SyntheticSource : public Source {
+  public:
+    SyntheticSource() = delete;
+    // frequency is the pitch of the sine and the top of the chirp, which sweeps up from 20 Hz once a second. Noise is
+    // uniform, seeded with seed, and independent between channels; the other signals are identical on every channel.
+    SyntheticSource(Signal signal, size_t sampleRate, size_t numChannels = 2, double frequency = 440.,
+                    uint32_t seed = 1);
+    void populateFrame(PulseView::Frame &frame);
+    void read(S16NESample *buffer, size_t numFrames);
+    size_t numChannels() const noexcept { return numChannels_; }
+    size_t sampleRate() const noexcept { return sampleRate_; }
+
+  private:
+    S16NESample nextTone() noexcept;
+    S16NESample nextNoise() noexcept;
+    Signal signal_;
+    size_t sampleRate_;
+    size_t numChannels_;
+    double frequency_;
+    double phase_{0.};
+    size_t position_{0};
+    uint32_t state_;
+    // Reused by populateFrame, so it only allocates when the frame width grows
+    fftw::FFTWVector<S16NESample> buffer_;
+};
+
+} // namespace PulseView::AudioSource
@@ -0,0 +1,67 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace PulseView {
+
+// Fixed set of threads for splitting one job into a few coarse tasks, e.g. the channels of a wide frame. The caller
+// works on the tasks too and returns once they're all done. Dispatching doesn't allocate. Longer work that mustn't hold
+// the caller up can be posted to run in the background instead.
+class TaskPool {
+  public:
+    TaskPool() = delete;
+    explicit TaskPool(size_t numThreads);
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+    ~TaskPool() noexcept;
+    // One thread per core besides the caller's, created on first use
+    static TaskPool &shared();
+    size_t numThreads() const noexcept { return threads_.size(); }
+    // Calls f(i) for every i in [0, numTasks) across the pool. Jobs from different callers run one at a time.
+    template <typename F> void parallelFor(size_t numTasks, F &&f) {
+        using Fn = std::remove_reference_t<F>;
+        run(numTasks, [](void *context, size_t i) { (*static_cast<Fn *>(context))(i); }, &f);
+    }
+    // Runs task later on one of the pool's threads, or on a thread of its own when the pool has none, so it never runs
+    // on the caller. Jobs from parallelFor go first. Posted tasks may run concurrently and in any order, and any not
+    // yet started when the pool is destroyed never run.
+    void post(std::function<void()> task);
+
+  private:
+    using TaskFn = void (*)(void *, size_t);
+    void run(size_t numTasks, TaskFn fn, void *context);
+    // Runs tasks of the current job until none are left, with lock held on entry and exit
+    void drain(std::unique_lock<std::mutex> &lock, uint64_t generation);
+    void work() noexcept;
+    void runPosted() noexcept;
+    std::mutex runMutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    TaskFn fn_{nullptr};
+    void *context_{nullptr};
+    size_t numTasks_{0};
+    size_t next_{0};
+    size_t remaining_{0};
+    uint64_t generation_{0};
+    bool running_{true};
+    std::deque<std::function<void()>> posted_;
+    std::vector<std::thread> threads_;
+    // Only started by post() when threads_ is empty
+    std::thread postThread_;
+};
+
+} // namespace PulseView
@@ -3,25 +3,118 @@
 // Date: 2020-05-16
 //
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <cxxopts.hpp>
 
 #include <application.h>
 
+namespace {
+
+void printLoudness(const PulseView::LoudnessMeter &meter) {
+    std::cout << "Integrated loudness " << meter.loudness().integrated << " LUFS, max true peak";
+    for (size_t c = 0; c < meter.numChannels(); ++c) {
+        std::cout << (c ? ", " : " ") << PulseView::toDecibels(meter.levels(c).maxTruePeak);
+    }
+    std::cout << " dBTP\n";
+}
+
+} // namespace
+
 int main(int argc, char *argv[]) {
     cxxopts::Options options{argv[0], "Simple graphical oscilloscope for pulseaudio"};
     try {
         size_t width = 800, height = 600;
         size_t log2FrameWidth = 11;
         size_t frameRate = 60;
+        size_t sampleRate = 48000;
+        size_t hopSize = 0;
+        auto plannerEffort = PulseView::fftw::PlannerEffort::Measure;
+        size_t fftThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        auto waveformMode = PulseView::WaveformMode::Auto;
+        auto spectrumScale = PulseView::SpectrumScale::Quadratic;
+        size_t numBars = 128;
+        auto spectrumView = PulseView::SpectrumView::Bars;
+        size_t spectrogramHistory = 512;
+        size_t historySeconds = 60;
+        std::string historyFile;
+        auto colormap = PulseView::Colormap::Inferno;
+        auto windowFunction = PulseView::fftw::WindowFunction::Rectangular;
+        std::string inputPath, outputPath, outputFormat = "png";
+        std::string tracePath, traceFormat = "csv";
+        std::string recordPath, snapshotPrefix = "pulseview-";
+        auto recordFormat = PulseView::RecordFormat::WAV;
+        size_t preTriggerSeconds = 0;
+        size_t analysisThreads = 0;
+        std::string pulseBackend = "simple", device;
+        size_t numChannels = 2;
+        PulseView::AudioSource::PCMStreamConfig pcmConfig;
+        std::string hudFont = "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf";
 
         using DimensionVec = std::vector<size_t>;
         options.add_options()("h,help", "Show help message", cxxopts::value<bool>())(
-            "d,dimensions", "Initial window dimensions",
-            cxxopts::value<DimensionVec>())("f,frame-rate", "Number of updates per second", cxxopts::value<size_t>())(
-            "w,log2-frame-width", "Log in base 2 of the number of samples shown on the screen at once",
+            "d,dimensions", "Initial window dimensions", cxxopts::value<DimensionVec>())(
+            "f,frame-rate", "Number of updates per second, with --vsync this should be the display's refresh rate",
+            cxxopts::value<size_t>())(
+            "vsync", "Present frames on vertical sync instead of sleeping until each is due", cxxopts::value<bool>())(
+            "fixed-quality", "Never draw fewer bars, decimate the waveform or shrink the FFT to keep to the frame rate",
+            cxxopts::value<bool>())(
+            "w,log2-frame-width", "Log in base 2 of the number of samples shown on the screen at once, [ and ] change "
+            "it while running", cxxopts::value<size_t>())(
+            "window", "Window applied before the FFT (rectangular, hann, hamming or blackman), W cycles through them",
+            cxxopts::value<std::string>())(
+            "p,fft-planner", "FFTW planner effort (estimate, measure or patient), plans are cached as wisdom",
+            cxxopts::value<std::string>())(
+            "fft-threads", "Threads each transform of 2^15 points or more is split over, defaults to one per core",
+            cxxopts::value<size_t>())(
+            "r,sample-rate", "Audio capture rate in Hz, independent of the frame width", cxxopts::value<size_t>())(
+            "s,hop-size", "Number of new samples between analysed windows, defaults to sample-rate / frame-rate",
+            cxxopts::value<size_t>())(
+            "waveform", "Waveform drawing (full, envelope or auto to decimate only when there are more samples than "
+            "pixels)", cxxopts::value<std::string>())(
+            "b,bars", "Number of spectrum bars per channel, 0 for one per pixel column", cxxopts::value<size_t>())(
+            "spectrum-scale", "Frequency axis of the spectrum (linear, quadratic, log or mel)",
+            cxxopts::value<std::string>())(
+            "spectrogram", "Show a scrolling spectrogram of every channel's average instead of bars",
+            cxxopts::value<bool>())(
+            "spectrogram-history", "Number of frames the spectrogram keeps", cxxopts::value<size_t>())(
+            "colormap", "Spectrogram colours (grayscale, heat, inferno or viridis)", cxxopts::value<std::string>())(
+            "history-seconds", "Seconds of audio kept to zoom out over with the mouse wheel, 0 to keep none",
+            cxxopts::value<size_t>())(
+            "history-file", "Keep that audio in this file rather than in memory, for histories of hours",
+            cxxopts::value<std::string>())(
+            "i,input", "Render a WAV or raw S16NE file offscreen as fast as possible instead of live audio",
+            cxxopts::value<std::string>())(
+            "o,output", "With --input, where to write the rendered frames (a directory for png, a file or - for raw)",
+            cxxopts::value<std::string>())(
+            "output-format", "Format of --output (png or raw for a stream of RGBA frames)",
+            cxxopts::value<std::string>())(
+            "hud", "Start with the latency overlay shown, F3 toggles it", cxxopts::value<bool>())(
+            "hud-font", "Font for the latency overlay's labels", cxxopts::value<std::string>())(
+            "meters", "Show peak, RMS and EBU R128 loudness meters, M toggles them and R resets them",
+            cxxopts::value<bool>())(
+            "trace", "Write every frame's stage timings to this file", cxxopts::value<std::string>())(
+            "record", "Record everything captured to this file", cxxopts::value<std::string>())(
+            "record-format", "Format of --record and snapshots (wav or raw S16NE)", cxxopts::value<std::string>())(
+            "pretrigger", "Keep this many seconds of audio for F5 to save as a snapshot", cxxopts::value<size_t>())(
+            "snapshot-prefix", "Where F5 saves snapshots, the time and extension are appended",
+            cxxopts::value<std::string>())(
+            "trace-format", "Format of --trace (csv or chrome for trace event JSON)", cxxopts::value<std::string>())(
+            "analysis-threads", "Analyse frames on this many worker threads while the last one is drawn, 0 to do "
+            "everything on the render thread", cxxopts::value<size_t>())(
+            "pulse-backend", "PulseAudio API to record with (simple, or stream for the lower latency asynchronous API)",
+            cxxopts::value<std::string>())(
+            "device", "PulseAudio source or monitor to record from, defaults to the server's default source",
+            cxxopts::value<std::string>())(
+            "c,command", "Read interleaved PCM at --sample-rate from this shell command's output instead of "
+            "PulseAudio, - for standard input", cxxopts::value<std::string>())(
+            "pcm-format", "Sample format of --command (s16, s32 or f32, native endian)", cxxopts::value<std::string>())(
+            "channels", "Channel count to record, or of --command or a raw --input, each is drawn in its own lane",
             cxxopts::value<size_t>());
         auto result = options.parse(argc, argv);
         if (result.count("help")) {
@@ -38,8 +131,8 @@ int main(int argc, char *argv[]) {
         }
         if (result.count("log2-frame-width")) {
             log2FrameWidth = result["log2-frame-width"].as<size_t>();
-            if (log2FrameWidth < 8 || log2FrameWidth > 12) {
-                throw cxxopts::OptionParseException("log2-frame-width is out of range [8..12]");
+            if (log2FrameWidth < PulseView::minLog2FrameSize || log2FrameWidth > PulseView::maxLog2FrameSize) {
+                throw cxxopts::OptionParseException("log2-frame-width is out of range [8..20]");
             }
         }
         if (result.count("frame-rate")) {
@@ -48,13 +141,338 @@ int main(int argc, char *argv[]) {
                 throw cxxopts::OptionParseException("frame-rate is out of range [1..120]");
             }
         }
+        if (result.count("sample-rate")) {
+            sampleRate = result["sample-rate"].as<size_t>();
+            if (sampleRate < 8000 || sampleRate > 192000) {
+                throw cxxopts::OptionParseException("sample-rate is out of range [8000..192000]");
+            }
+        }
+        if (result.count("hop-size")) {
+            hopSize = result["hop-size"].as<size_t>();
+            if (hopSize < 1) {
+                throw cxxopts::OptionParseException("hop-size must be at least 1");
+            }
+        }
+        if (result.count("fft-planner")) {
+            const auto effort = result["fft-planner"].as<std::string>();
+            if (effort == "estimate") {
+                plannerEffort = PulseView::fftw::PlannerEffort::Estimate;
+            } else if (effort == "measure") {
+                plannerEffort = PulseView::fftw::PlannerEffort::Measure;
+            } else if (effort == "patient") {
+                plannerEffort = PulseView::fftw::PlannerEffort::Patient;
+            } else {
+                throw cxxopts::OptionParseException("fft-planner must be one of estimate, measure or patient");
+            }
+        }
+        if (result.count("fft-threads")) {
+            fftThreads = result["fft-threads"].as<size_t>();
+            if (fftThreads < 1 || fftThreads > 64) {
+                throw cxxopts::OptionParseException("fft-threads is out of range [1..64]");
+            }
+        }
+        PulseView::fftw::setPlannerThreads(fftThreads);
+        if (result.count("waveform")) {
+            const auto mode = result["waveform"].as<std::string>();
+            if (mode == "auto") {
+                waveformMode = PulseView::WaveformMode::Auto;
+            } else if (mode == "full") {
+                waveformMode = PulseView::WaveformMode::Full;
+            } else if (mode == "envelope") {
+                waveformMode = PulseView::WaveformMode::Envelope;
+            } else {
+                throw cxxopts::OptionParseException("waveform must be one of full, envelope or auto");
+            }
+        }
+        if (result.count("bars")) {
+            numBars = result["bars"].as<size_t>();
+            if (numBars > 1024) {
+                throw cxxopts::OptionParseException("bars is out of range [0..1024]");
+            }
+        }
+        if (result.count("spectrum-scale")) {
+            const auto scale = result["spectrum-scale"].as<std::string>();
+            if (scale == "linear") {
+                spectrumScale = PulseView::SpectrumScale::Linear;
+            } else if (scale == "quadratic") {
+                spectrumScale = PulseView::SpectrumScale::Quadratic;
+            } else if (scale == "log") {
+                spectrumScale = PulseView::SpectrumScale::Logarithmic;
+            } else if (scale == "mel") {
+                spectrumScale = PulseView::SpectrumScale::Mel;
+            } else {
+                throw cxxopts::OptionParseException("spectrum-scale must be one of linear, quadratic, log or mel");
+            }
+        }
+        if (result.count("spectrogram")) {
+            spectrumView = PulseView::SpectrumView::Spectrogram;
+        }
+        if (result.count("spectrogram-history")) {
+            spectrogramHistory = result["spectrogram-history"].as<size_t>();
+            if (spectrogramHistory < 1 || spectrogramHistory > 16384) {
+                throw cxxopts::OptionParseException("spectrogram-history is out of range [1..16384]");
+            }
+        }
+        if (result.count("history-seconds")) {
+            historySeconds = result["history-seconds"].as<size_t>();
+            if (historySeconds > 86400) {
+                throw cxxopts::OptionParseException("history-seconds is out of range [0..86400]");
+            }
+        }
+        if (result.count("history-file")) {
+            historyFile = result["history-file"].as<std::string>();
+        }
+        if (result.count("colormap")) {
+            const auto name = result["colormap"].as<std::string>();
+            if (name == "grayscale") {
+                colormap = PulseView::Colormap::Grayscale;
+            } else if (name == "heat") {
+                colormap = PulseView::Colormap::Heat;
+            } else if (name == "inferno") {
+                colormap = PulseView::Colormap::Inferno;
+            } else if (name == "viridis") {
+                colormap = PulseView::Colormap::Viridis;
+            } else {
+                throw cxxopts::OptionParseException("colormap must be one of grayscale, heat, inferno or viridis");
+            }
+        }
+        if (result.count("window")) {
+            const auto name = result["window"].as<std::string>();
+            bool found = false;
+            for (size_t w = 0; w < PulseView::fftw::numWindowFunctions; ++w) {
+                const auto candidate = static_cast<PulseView::fftw::WindowFunction>(w);
+                if (name == PulseView::fftw::windowFunctionName(candidate)) {
+                    windowFunction = candidate;
+                    found = true;
+                }
+            }
+            if (!found) {
+                throw cxxopts::OptionParseException("window must be one of rectangular, hann, hamming or blackman");
+            }
+        }
+
+        if (result.count("input")) {
+            inputPath = result["input"].as<std::string>();
+        }
+        if (result.count("output")) {
+            if (inputPath.empty()) {
+                throw cxxopts::OptionParseException("output requires input");
+            }
+            outputPath = result["output"].as<std::string>();
+        }
+        if (result.count("output-format")) {
+            outputFormat = result["output-format"].as<std::string>();
+            if (outputFormat != "png" && outputFormat != "raw") {
+                throw cxxopts::OptionParseException("output-format must be one of png or raw");
+            }
+        }
+
+        if (result.count("analysis-threads")) {
+            analysisThreads = result["analysis-threads"].as<size_t>();
+            if (analysisThreads > 16) {
+                throw cxxopts::OptionParseException("analysis-threads is out of range [0..16]");
+            }
+        }
+        if (result.count("pulse-backend")) {
+            pulseBackend = result["pulse-backend"].as<std::string>();
+            if (pulseBackend != "simple" && pulseBackend != "stream") {
+                throw cxxopts::OptionParseException("pulse-backend must be one of simple or stream");
+            }
+        }
+        if (result.count("device")) {
+            device = result["device"].as<std::string>();
+        }
+        if (result.count("command")) {
+            pcmConfig.command = result["command"].as<std::string>();
+        }
+        if (result.count("pcm-format")) {
+            const auto format = result["pcm-format"].as<std::string>();
+            if (format == "s16") {
+                pcmConfig.format = PulseView::conversion::SampleFormat::S16NE;
+            } else if (format == "s32") {
+                pcmConfig.format = PulseView::conversion::SampleFormat::S32NE;
+            } else if (format == "f32") {
+                pcmConfig.format = PulseView::conversion::SampleFormat::F32NE;
+            } else {
+                throw cxxopts::OptionParseException("pcm-format must be one of s16, s32 or f32");
+            }
+        }
+        if (result.count("channels")) {
+            numChannels = result["channels"].as<size_t>();
+            // PulseAudio's PA_CHANNELS_MAX
+            if (numChannels < 1 || numChannels > 32) {
+                throw cxxopts::OptionParseException("channels is out of range [1..32]");
+            }
+        }
+        if (result.count("hud-font")) {
+            hudFont = result["hud-font"].as<std::string>();
+        }
+        if (result.count("trace")) {
+            tracePath = result["trace"].as<std::string>();
+        }
+        if (result.count("record")) {
+            recordPath = result["record"].as<std::string>();
+        }
+        if (result.count("record-format")) {
+            const auto format = result["record-format"].as<std::string>();
+            if (format == "wav") {
+                recordFormat = PulseView::RecordFormat::WAV;
+            } else if (format == "raw") {
+                recordFormat = PulseView::RecordFormat::Raw;
+            } else {
+                throw cxxopts::OptionParseException("record-format must be one of wav or raw");
+            }
+        }
+        if (result.count("pretrigger")) {
+            preTriggerSeconds = result["pretrigger"].as<size_t>();
+            if (preTriggerSeconds > 600) {
+                throw cxxopts::OptionParseException("pretrigger is out of range [0..600]");
+            }
+        }
+        if (result.count("snapshot-prefix")) {
+            snapshotPrefix = result["snapshot-prefix"].as<std::string>();
+        }
+        if (result.count("trace-format")) {
+            traceFormat = result["trace-format"].as<std::string>();
+            if (traceFormat != "csv" && traceFormat != "chrome") {
+                throw cxxopts::OptionParseException("trace-format must be one of csv or chrome");
+            }
+        }
+
+        if (!inputPath.empty()) {
+            PulseView::AudioSource::FileSource source{inputPath, sampleRate, numChannels};
+            PulseView::Frame frame{log2FrameWidth, source.numChannels(), plannerEffort};
+            frame.setWindow(windowFunction);
+            sampleRate = source.sampleRate();
+            if (!hopSize) {
+                hopSize = std::max(sampleRate / frameRate, (size_t)1);
+            }
+            std::unique_ptr<PulseView::FrameSink> sink;
+            if (!outputPath.empty() && outputFormat == "png") {
+                sink = std::make_unique<PulseView::PNGSequenceSink>(outputPath);
+            } else if (!outputPath.empty()) {
+                sink = std::make_unique<PulseView::RawVideoSink>(outputPath);
+            }
+            sf::RenderTexture texture;
+            if (!texture.create(width, height)) {
+                throw std::runtime_error("Failed to create offscreen render texture");
+            }
+            PulseView::OfflineApplication app{texture, source, frame, hopSize, sink.get()};
+            app.renderModel().setWaveformMode(waveformMode);
+            app.renderModel().setSpectrum(spectrumScale, numBars, sampleRate);
+            app.renderModel().setSpectrumView(spectrumView);
+            app.renderModel().setSpectrogram(spectrogramHistory, colormap);
+            if (result.count("meters")) {
+                app.enableMeters(sampleRate);
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const auto numRendered = app.run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            const double audioSeconds = static_cast<double>(source.numFrames()) / sampleRate;
+            std::cerr << "Rendered " << numRendered << " frames of " << audioSeconds << "s of audio in "
+                      << elapsed.count() << "s (" << audioSeconds / elapsed.count() << "x real time)\n";
+            if (const auto *meter = app.loudnessMeter()) {
+                printLoudness(*meter);
+            }
+            return 0;
+        }
+        if (!hopSize) {
+            hopSize = std::max(sampleRate / frameRate, (size_t)1);
+        }
 
         sf::RenderWindow window{sf::VideoMode(width, height), "PulseView"};
-        PulseView::Frame frame{log2FrameWidth};
-        PulseView::AudioSource::PulseAudioSource source{frameRate * (1u << log2FrameWidth)};
+        window.setVerticalSyncEnabled(result.count("vsync"));
+        std::unique_ptr<PulseView::AudioSource::Source> source;
+        if (result.count("command")) {
+            if (pcmConfig.command == "-") {
+                pcmConfig.command.clear();
+            }
+            pcmConfig.sampleRate = sampleRate;
+            pcmConfig.numChannels = numChannels;
+            source = std::make_unique<PulseView::AudioSource::PCMProcessSource>(pcmConfig);
+        } else if (pulseBackend == "stream") {
+            source = std::make_unique<PulseView::AudioSource::PulseAudioStreamSource>(sampleRate, hopSize, device,
+                                                                                      numChannels);
+        } else {
+            source =
+                std::make_unique<PulseView::AudioSource::PulseAudioSource>(sampleRate, hopSize, device, numChannels);
+        }
 
-        PulseView::Application app{window, source, frame};
+        PulseView::Frame frame{log2FrameWidth, source->numChannels(), plannerEffort};
+        // Outlives app, whose capture thread pushes to it
+        std::unique_ptr<PulseView::Recorder> recorder;
+        if (!recordPath.empty() || preTriggerSeconds > 0) {
+            recorder = std::make_unique<PulseView::Recorder>(source->numChannels(), sampleRate, recordFormat,
+                                                             recordPath, preTriggerSeconds * sampleRate);
+        }
+        PulseView::Application app{window, *source, frame, hopSize};
+        app.renderModel().setWaveformMode(waveformMode);
+        app.renderModel().setSpectrum(spectrumScale, numBars, sampleRate);
+        app.renderModel().setSpectrumView(spectrumView);
+        app.renderModel().setSpectrogram(spectrogramHistory, colormap);
+        app.setWindowFunction(windowFunction);
+        app.framePacer().setPeriod(1000000 / frameRate, !result.count("vsync"));
+        app.framePacer().setAdaptive(!result.count("fixed-quality"));
+        app.latencyOverlay().setFrameBudget(1000000 / frameRate);
+        app.latencyOverlay().setFontPath(hudFont);
+        app.showLatencyOverlay(result.count("hud"));
+        if (analysisThreads > 0) {
+            app.enablePipeline(analysisThreads, plannerEffort);
+        }
+        if (historySeconds > 0) {
+            app.enableHistory(historySeconds * sampleRate, historyFile);
+        }
+        if (recorder) {
+            app.setRecorder(recorder.get(), snapshotPrefix);
+        }
+        if (result.count("meters")) {
+            app.enableMeters(sampleRate);
+        }
+        std::unique_ptr<PulseView::FrameTrace> trace;
+        if (!tracePath.empty()) {
+            const auto format =
+                traceFormat == "csv" ? PulseView::TraceFormat::CSV : PulseView::TraceFormat::ChromeTrace;
+            trace = std::make_unique<PulseView::FrameTrace>(tracePath, format);
+            app.setFrameTrace(trace.get());
+        }
         app.run();
+        const auto metrics = app.captureMetrics();
+        std::cout << "Captured " << metrics.framesCaptured << " frames, " << metrics.overruns << " overruns ("
+                  << metrics.droppedFrames << " frames dropped), " << metrics.underruns << " underruns, "
+                  << metrics.staleFrames << " stale frames skipped\n";
+        if (const auto *meter = app.loudnessMeter()) {
+            printLoudness(*meter);
+        }
+        if (recorder) {
+            // Still running until app is gone, so anything queued is written after this
+            const auto recorderMetrics = recorder->metrics();
+            std::cout << "Recorded " << recorderMetrics.framesWritten << " frames"
+                      << (recorderMetrics.failed ? " before failing, " : ", ") << recorderMetrics.droppedBlocks
+                      << " blocks dropped (" << recorderMetrics.droppedFrames << " frames), "
+                      << recorderMetrics.snapshotsSaved << " snapshots saved\n";
+        }
+        if (const auto pipelineMetrics = app.pipelineMetrics()) {
+            std::cout << "Analysed " << pipelineMetrics->framesAnalysed << " frames, "
+                      << pipelineMetrics->framesDropped << " superseded before being drawn\n";
+        }
+        const auto cacheMetrics = app.frameCacheMetrics();
+        std::cout << "Frame cache: " << cacheMetrics.hits << " hits, " << cacheMetrics.misses << " sizes planned, "
+                  << cacheMetrics.evictions << " evicted\n";
+        const auto &pacing = app.pacingMetrics();
+        std::cout << "Rendered " << pacing.framesRendered << " frames, skipped " << pacing.framesSkipped
+                  << " without new audio, " << pacing.overBudget << " over budget, " << pacing.missedDeadlines
+                  << " missed deadlines, quality dropped " << pacing.degradations << " times and recovered "
+                  << pacing.recoveries << " times\n";
+        for (size_t q = 0; q < PulseView::numRenderQualities; ++q) {
+            std::cout << PulseView::renderQualityName(static_cast<PulseView::RenderQuality>(q)) << ": "
+                      << pacing.framesAtQuality[q] << " frames\n";
+        }
+        for (size_t s = 0; s < PulseView::numStages; ++s) {
+            const auto stage = static_cast<PulseView::Stage>(s);
+            const auto &histogram = app.latencyStats()[stage];
+            std::cout << PulseView::stageName(stage) << ": p50 " << histogram.percentile(0.5) << "us, p99 "
+                      << histogram.percentile(0.99) << "us, max " << histogram.max() << "us\n";
+        }
     } catch (cxxopts::OptionParseException &e) {
         std::cout << options.help() << '\n';
         std::cerr << "Encountered critical error parsing options: " << e.what() << '\n';
@@ -0,0 +1,195 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "analysis_pipeline.h"
+
+namespace PulseView {
+
+namespace {
+
+// The current set and the one before it, enough to flip between two sizes without planning. Each holds a frame per
+// slot, which at 2^20 points is already a lot of memory.
+constexpr size_t setsKept = 2;
+
+} // namespace
+
+AnalysisPipeline::AnalysisPipeline(CaptureThread &capture, size_t numChannels, size_t log2NumSamples,
+                                   size_t numWorkers, fftw::PlannerEffort plannerEffort,
+                                   fftw::WindowFunction windowFunction)
+    : capture_{capture}, numChannels_{numChannels}, windowFrames_{((size_t)1) << log2NumSamples},
+      numWorkers_{numWorkers}, frames_{numChannels, numWorkers + 2, setsKept}, windowFunction_{windowFunction},
+      window_(windowFrames_ * numChannels), pending_(windowFrames_ * numChannels), slots_(numWorkers + 2) {
+    if (numWorkers_ == 0) {
+        die("AnalysisPipeline needs at least one worker");
+    }
+    // The first set is planned here with the effort asked for, later ones in the background with Estimate
+    set_ = frames_.acquire(log2NumSamples, windowFunction, plannerEffort);
+    for (auto &slot : slots_) {
+        bind(slot);
+    }
+    for (size_t i = 0; i < numWorkers_; ++i) {
+        workers_.emplace_back(&AnalysisPipeline::work, this);
+    }
+}
+
+AnalysisPipeline::~AnalysisPipeline() noexcept {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        running_ = false;
+    }
+    queued_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+AnalysisPipeline::Slot *AnalysisPipeline::findSlot(SlotState state) noexcept {
+    for (auto &slot : slots_) {
+        if (slot.state == state) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void AnalysisPipeline::seed(const S16NESample *interleaved) {
+    std::copy(interleaved, interleaved + window_.size(), window_.begin());
+    windowChanged_ = true;
+}
+
+void AnalysisPipeline::setFFTSize(size_t log2NumSamples) {
+    if (log2NumSamples == set_->log2Size) {
+        pendingSet_.reset();
+    } else if (!pendingSet_ || pendingSet_->log2Size() != log2NumSamples) {
+        pendingSet_ = frames_.prepare(log2NumSamples, windowFunction_);
+    }
+}
+
+void AnalysisPipeline::setWindowFunction(fftw::WindowFunction windowFunction) {
+    windowFunction_ = windowFunction;
+    windowChanged_ = true;
+}
+
+void AnalysisPipeline::bind(Slot &slot) {
+    if (slot.set == set_) {
+        return;
+    }
+    slot.set = set_;
+    // Each slot only ever uses its own frame of a set, so no two slots share one whichever sets they're on
+    slot.frame = set_->frames[&slot - slots_.data()].get();
+    // Only allocates for a larger window than the slot has held before
+    slot.window.resize(window_.size());
+}
+
+// Vectors only shrink in size, so flipping back and forth doesn't allocate
+void AnalysisPipeline::switchSet(std::shared_ptr<FrameSet> set) {
+    const auto oldFrames = windowFrames_;
+    set_ = std::move(set);
+    windowFrames_ = set_->frames.front()->numSamples;
+    pending_.resize(windowFrames_ * numChannels_);
+    if (history_) {
+        window_.resize(windowFrames_ * numChannels_);
+        history_->copyNewest(window_.data(), windowFrames_);
+    } else if (windowFrames_ < oldFrames) {
+        // Keeps the newest frames
+        std::copy(window_.end() - windowFrames_ * numChannels_, window_.end(), window_.begin());
+        window_.resize(windowFrames_ * numChannels_);
+    } else {
+        // Keeps every frame, newest last, with silence before them
+        window_.resize(windowFrames_ * numChannels_);
+        const auto kept = oldFrames * numChannels_;
+        std::copy_backward(window_.begin(), window_.begin() + kept, window_.end());
+        std::fill(window_.begin(), window_.end() - kept, 0);
+    }
+    windowChanged_ = true;
+}
+
+void AnalysisPipeline::slideWindow(size_t numFrames) {
+    const auto newSamples = numFrames * numChannels_;
+    if (newSamples >= window_.size()) {
+        std::copy(pending_.begin() + (newSamples - window_.size()), pending_.begin() + newSamples, window_.begin());
+        return;
+    }
+    std::copy(window_.begin() + newSamples, window_.end(), window_.begin());
+    std::copy(pending_.begin(), pending_.begin() + newSamples, window_.end() - newSamples);
+}
+
+bool AnalysisPipeline::update() {
+    if (pendingSet_) {
+        if (auto set = pendingSet_->ready()) {
+            pendingSet_.reset();
+            switchSet(std::move(set));
+        }
+    }
+    const auto numFrames = capture_.pop(pending_.data(), windowFrames_);
+    if (numFrames > 0) {
+        slideWindow(numFrames);
+        windowChanged_ = true;
+    }
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (windowChanged_ && busyWorkers_ < numWorkers_) {
+        // Never null: at most numWorkers_ slots are queued or analysing, one is ready and one is being drawn
+        auto *slot = findSlot(SlotState::Free);
+        bind(*slot);
+        std::copy(window_.begin(), window_.end(), slot->window.begin());
+        slot->windowFunction = windowFunction_;
+        slot->sequence = ++nextSequence_;
+        slot->state = SlotState::Queued;
+        ++busyWorkers_;
+        windowChanged_ = false;
+        queued_.notify_one();
+    }
+    if (!ready_) {
+        return false;
+    }
+    if (rendering_) {
+        rendering_->state = SlotState::Free;
+    }
+    rendering_ = ready_;
+    rendering_->state = SlotState::Rendering;
+    ready_ = nullptr;
+    return true;
+}
+
+void AnalysisPipeline::work() noexcept {
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+        queued_.wait(lock, [this] { return !running_ || findSlot(SlotState::Queued); });
+        if (!running_) {
+            return;
+        }
+        auto *slot = findSlot(SlotState::Queued);
+        slot->state = SlotState::Analysing;
+        lock.unlock();
+        // Only computes the coefficients when the window or the slot's set changed
+        slot->frame->setWindow(slot->windowFunction);
+        slot->frame->loadInterleaved(slot->window.data(), numChannels_);
+        slot->frame->finalize();
+        lock.lock();
+        --busyWorkers_;
+        ++framesAnalysed_;
+        // Workers can finish out of order, the older of the two results is never drawn
+        auto *stale = slot;
+        if (!ready_ || ready_->sequence < slot->sequence) {
+            std::swap(stale, ready_);
+            ready_->state = SlotState::Ready;
+        }
+        if (stale) {
+            stale->state = SlotState::Free;
+            ++framesDropped_;
+        }
+    }
+}
+
+PipelineMetrics AnalysisPipeline::metrics() const noexcept {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return PipelineMetrics{framesAnalysed_, framesDropped_};
+}
+
+} // namespace PulseView
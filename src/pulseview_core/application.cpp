@@ -3,19 +3,178 @@
 // Date: 2020-06-20
 //
 
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
 #include "application.h"
 #include "pulseview.h"
 
 namespace PulseView {
 
-Application::Application(sf::RenderWindow &window, AudioSource::Source &source, Frame &frame)
-    : window_{window}, model_{window_}, frame_{frame}, source_{source} {}
+namespace {
+
+// Each notch of the wheel zooms by this factor
+constexpr double zoomStep = 1.25;
+// and each notch or arrow key press pans by this fraction of the span
+constexpr double panStep = .1;
+// The range - and = step the number of bars through
+constexpr size_t minBars = 8;
+constexpr size_t maxBars = 1024;
+
+} // namespace
+
+Application::Application(sf::RenderWindow &window, AudioSource::Source &source, Frame &frame, size_t hopFrames)
+    : window_{window}, model_{window_}, frame_{frame}, source_{source},
+      capture_{source_, frame_.numSamples, hopFrames, &stats_}, analysed_{capture_, frame_},
+      log2Size_{frame_.log2Size} {}
+
+void Application::enablePipeline(size_t numWorkers, fftw::PlannerEffort plannerEffort) {
+    pipeline_.emplace(capture_, source_.numChannels(), log2Size_, numWorkers, plannerEffort, windowFunction_);
+    pipeline_->setHistory(&analysed_.recentAudio());
+    pacer_.setLowestQuality(RenderQuality::Decimated);
+}
+
+size_t Application::wantedLog2Size() const noexcept {
+    auto log2Size = log2Size_;
+    if (pacer_.quality() == RenderQuality::SmallerFFT && log2Size > minLog2FrameSize) {
+        --log2Size;
+    }
+    return log2Size;
+}
+
+void Application::setFFTSize(size_t log2Size) {
+    log2Size = std::clamp(log2Size, minLog2FrameSize, maxLog2FrameSize);
+    if (log2Size == log2Size_) {
+        return;
+    }
+    const auto previousFrames = size_t{1} << log2Size_;
+    log2Size_ = log2Size;
+    if (pipeline_) {
+        pipeline_->setFFTSize(log2Size_);
+    }
+    // A view showing exactly the frame keeps doing so
+    if (history_ && historyView_.live && historyView_.spanFrames == previousFrames) {
+        setHistoryView(history_->framesWritten(), size_t{1} << log2Size_);
+    }
+}
+
+void Application::setWindowFunction(fftw::WindowFunction window) {
+    if (window == windowFunction_) {
+        return;
+    }
+    windowFunction_ = window;
+    analysed_.setWindowFunction(window);
+    if (pipeline_) {
+        pipeline_->setWindowFunction(window);
+        return;
+    }
+    // Shows the new window straight away, even without new audio
+    analysed_.current().finalize();
+}
+
+FrameCacheMetrics Application::frameCacheMetrics() const {
+    auto metrics = analysed_.metrics();
+    if (pipeline_) {
+        const auto pipelineMetrics = pipeline_->frameCacheMetrics();
+        metrics.hits += pipelineMetrics.hits;
+        metrics.misses += pipelineMetrics.misses;
+        metrics.evictions += pipelineMetrics.evictions;
+    }
+    return metrics;
+}
+
+void Application::enableHistory(size_t capacityFrames, const std::string &backingPath) {
+    history_ = std::make_unique<SignalHistory>(source_.numChannels(), capacityFrames, backingPath);
+    analysed_.setHistory(history_.get());
+    if (pipeline_) {
+        pipeline_->setHistory(history_.get());
+    }
+    historyView_ = HistoryView{size_t{1} << log2Size_, 0, true};
+    model_.showHistory(history_.get(), historyView_);
+}
+
+void Application::enableMeters(size_t sampleRate) {
+    meter_ = std::make_unique<LoudnessMeter>(source_.numChannels(), sampleRate);
+    capture_.setMeter(meter_.get());
+    showMeters_ = true;
+    model_.showMeters(meter_.get());
+}
+
+void Application::setHistoryView(double end, uint64_t spanFrames) {
+    const auto newest = history_->framesWritten();
+    historyView_.spanFrames = spanFrames;
+    historyView_.live = end >= newest;
+    historyView_.endFrame =
+        historyView_.live ? newest : static_cast<uint64_t>(std::max<double>(end, history_->oldestFrame()));
+    model_.showHistory(history_.get(), historyView_);
+}
+
+// The frame under the cursor stays where it is
+void Application::zoomHistory(float delta, int x) {
+    const auto width = std::max(window_.getSize().x, 1u);
+    const double end = historyView_.live ? history_->framesWritten() : historyView_.endFrame;
+    const double toRight = 1. - std::clamp(static_cast<double>(x) / width, 0., 1.);
+    const double anchor = end - historyView_.spanFrames * toRight;
+    const auto span = std::clamp<double>(std::round(historyView_.spanFrames * std::pow(zoomStep, -delta)),
+                                         size_t{1} << log2Size_, history_->capacityFrames());
+    setHistoryView(anchor + span * toRight, static_cast<uint64_t>(span));
+}
+
+void Application::panHistory(float delta) {
+    const double end = historyView_.live ? history_->framesWritten() : historyView_.endFrame;
+    setHistoryView(end + delta * panStep * historyView_.spanFrames, historyView_.spanFrames);
+}
+
+void Application::setRecorder(Recorder *recorder, const std::string &snapshotPrefix) {
+    recorder_ = recorder;
+    snapshotPrefix_ = snapshotPrefix;
+    capture_.setRecorder(recorder);
+}
+
+std::optional<PipelineMetrics> Application::pipelineMetrics() const noexcept {
+    if (!pipeline_) {
+        return std::nullopt;
+    }
+    return pipeline_->metrics();
+}
 
 void Application::run() {
     sf::Event ev;
     bool running{true};
+    FrameTiming timing{};
+    // Set whenever the window needs drawing even without new audio
+    bool redraw{true};
+    model_.setQuality(pacer_.quality());
     while (running) {
-        source_.populateFrame(frame_);
+        pacer_.waitForNextFrame();
+        const auto frameStart = LatencyClock::now();
+        auto stageStart = frameStart;
+        auto endStage = [&](Stage stage) {
+            const auto now = LatencyClock::now();
+            const auto s = static_cast<size_t>(stage);
+            timing.start[s] = stageStart;
+            timing.micros[s] = toMicros(now - stageStart);
+            stats_[stage].record(timing.micros[s]);
+            stageStart = now;
+        };
+
+        const Frame *frame = &frame_;
+        if (pipeline_) {
+            timing.hasAudio = pipeline_->update();
+            // frame_ is only drawn until the pipeline's first frame is ready
+            if (pipeline_->newest()) {
+                frame = pipeline_->newest();
+            }
+        } else {
+            if (analysed_.update(wantedLog2Size())) {
+                redraw = true;
+            }
+            auto &analysed = analysed_.current();
+            timing.hasAudio = capture_.populateFrame(analysed);
+            frame = &analysed;
+        }
+        endStage(Stage::Capture);
         while (window_.pollEvent(ev)) {
             switch (ev.type) {
             case sf::Event::Closed: {
@@ -24,16 +183,130 @@ void Application::run() {
             }
             case sf::Event::Resized: {
                 model_.resize(ev.size.width, ev.size.height);
+                redraw = true;
+                break;
+            }
+            case sf::Event::KeyPressed: {
+                if (ev.key.code == sf::Keyboard::F3) {
+                    showOverlay_ = !showOverlay_;
+                    redraw = true;
+                } else if (history_ && (ev.key.code == sf::Keyboard::Left || ev.key.code == sf::Keyboard::Right)) {
+                    panHistory(ev.key.code == sf::Keyboard::Left ? -1.f : 1.f);
+                    redraw = true;
+                } else if (history_ && ev.key.code == sf::Keyboard::Home) {
+                    setHistoryView(history_->framesWritten(), size_t{1} << log2Size_);
+                    redraw = true;
+                } else if (ev.key.code == sf::Keyboard::LBracket || ev.key.code == sf::Keyboard::RBracket) {
+                    setFFTSize(ev.key.code == sf::Keyboard::LBracket ? log2Size_ - 1 : log2Size_ + 1);
+                    redraw = true;
+                } else if (ev.key.code == sf::Keyboard::W) {
+                    const auto next = (static_cast<size_t>(windowFunction_) + 1) % fftw::numWindowFunctions;
+                    setWindowFunction(static_cast<fftw::WindowFunction>(next));
+                    redraw = true;
+                } else if (ev.key.code == sf::Keyboard::Hyphen || ev.key.code == sf::Keyboard::Equal) {
+                    // From one bar per column, start from the default
+                    const auto numBars = model_.numBars() ? model_.numBars() : 128;
+                    const auto next = ev.key.code == sf::Keyboard::Hyphen ? numBars / 2 : numBars * 2;
+                    model_.setNumBars(std::clamp(next, minBars, maxBars));
+                    redraw = true;
+                } else if (meter_ && ev.key.code == sf::Keyboard::M) {
+                    showMeters_ = !showMeters_;
+                    model_.showMeters(showMeters_ ? meter_.get() : nullptr);
+                    redraw = true;
+                } else if (meter_ && ev.key.code == sf::Keyboard::R) {
+                    meter_->reset();
+                    redraw = true;
+                } else if (recorder_ && ev.key.code == sf::Keyboard::F5) {
+                    const auto now = std::time(nullptr);
+                    char stamp[32];
+                    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+                    const auto *extension = recorder_->format() == RecordFormat::WAV ? ".wav" : ".raw";
+                    recorder_->saveSnapshot(snapshotPrefix_ + stamp + extension);
+                }
+                break;
+            }
+            case sf::Event::MouseWheelScrolled: {
+                if (!history_) {
+                    break;
+                }
+                const auto &scroll = ev.mouseWheelScroll;
+                if (scroll.wheel == sf::Mouse::HorizontalWheel || sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ||
+                    sf::Keyboard::isKeyPressed(sf::Keyboard::RShift)) {
+                    panHistory(-scroll.delta);
+                } else {
+                    zoomHistory(scroll.delta, scroll.x);
+                }
+                redraw = true;
                 break;
             }
             default:
                 break;
             }
         }
+        endStage(Stage::Events);
+        // Redrawing the same audio would only present an identical image
+        if (!timing.hasAudio && !redraw) {
+            pacer_.frameSkipped();
+            continue;
+        }
+        redraw = false;
 
-        model_.drawFrame(frame_);
+        model_.drawFrame(*frame, timing.hasAudio);
+        if (showOverlay_) {
+            overlay_.draw(window_, stats_);
+        }
+        endStage(Stage::Draw);
+        const auto workMicros = toMicros(stageStart - frameStart);
+        // Includes any wait for vsync
         window_.display();
+        endStage(Stage::Display);
+        if (pacer_.frameRendered(workMicros)) {
+            model_.setQuality(pacer_.quality());
+        }
+
+        const auto frameEnd = stageStart;
+        timing.start[static_cast<size_t>(Stage::Frame)] = frameStart;
+        timing.micros[static_cast<size_t>(Stage::Frame)] = toMicros(frameEnd - frameStart);
+        stats_[Stage::Frame].record(timing.micros[static_cast<size_t>(Stage::Frame)]);
+        if (timing.hasAudio) {
+            const auto newest = capture_.newestCapture();
+            timing.micros[static_cast<size_t>(Stage::SourceLatency)] = newest.sourceLatencyMicros;
+            timing.micros[static_cast<size_t>(Stage::AudioToPhoton)] =
+                newest.sourceLatencyMicros + toMicros(frameEnd - newest.capturedAt);
+            stats_[Stage::AudioToPhoton].record(timing.micros[static_cast<size_t>(Stage::AudioToPhoton)]);
+        }
+        if (trace_) {
+            trace_->record(timing);
+        }
+        ++timing.index;
+    }
+}
+
+OfflineApplication::OfflineApplication(sf::RenderTexture &texture, AudioSource::FileSource &source, Frame &frame,
+                                       size_t hopFrames, FrameSink *sink)
+    : texture_{texture}, model_{texture_}, frame_{frame}, source_{source}, hopFrames_{hopFrames}, sink_{sink},
+      hop_(hopFrames * source.numChannels()) {}
+
+void OfflineApplication::enableMeters(size_t sampleRate) {
+    meter_ = std::make_unique<LoudnessMeter>(source_.numChannels(), sampleRate);
+    model_.showMeters(meter_.get());
+}
+
+size_t OfflineApplication::run() {
+    size_t numRendered{0};
+    frame_.clear();
+    while (!source_.finished()) {
+        source_.read(hop_.data(), hopFrames_);
+        frame_.advance(hop_.data(), hopFrames_, source_.numChannels(), meter_.get());
+        frame_.finalize();
+        model_.drawFrame(frame_);
+        texture_.display();
+        if (sink_) {
+            sink_->write(texture_.getTexture().copyToImage());
+        }
+        ++numRendered;
     }
+    return numRendered;
 }
 
 } // namespace PulseView
@@ -0,0 +1,138 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+
+#include "capture_thread.h"
+
+namespace PulseView {
+
+namespace {
+
+// Enough slack that a few slow render frames don't cause overruns
+constexpr size_t ringWindows = 4;
+
+} // namespace
+
+CaptureThread::CaptureThread(AudioSource::Source &source, size_t windowFrames, size_t blockFrames,
+                             LatencyStats *stats)
+    : source_{source}, numChannels_{source.numChannels()}, windowFrames_{windowFrames}, blockFrames_{blockFrames},
+      stats_{stats}, ring_{ringWindows * std::max(windowFrames, blockFrames) * numChannels_},
+      pending_(windowFrames * numChannels_), thread_{&CaptureThread::run, this} {}
+
+CaptureThread::~CaptureThread() noexcept {
+    running_.store(false, std::memory_order_relaxed);
+    // A source with nothing to read would otherwise keep the join waiting forever
+    source_.interrupt();
+    thread_.join();
+}
+
+void CaptureThread::run() noexcept {
+    std::vector<S16NESample> block(blockFrames_ * numChannels_);
+    try {
+        while (running_.load(std::memory_order_relaxed)) {
+            const auto readStart = LatencyClock::now();
+            source_.read(block.data(), blockFrames_);
+            // An interrupted read's block is incomplete
+            if (!running_.load(std::memory_order_relaxed)) {
+                break;
+            }
+            if (stats_) {
+                const auto readEnd = LatencyClock::now();
+                const auto latency = source_.latencyMicros();
+                (*stats_)[Stage::SourceRead].record(toMicros(readEnd - readStart));
+                (*stats_)[Stage::SourceLatency].record(latency);
+                // Published before the push, so the consumer may see a block's timing just before the block itself
+                newestCaptureTicks_.store(readEnd.time_since_epoch().count(), std::memory_order_relaxed);
+                newestSourceLatency_.store(latency, std::memory_order_relaxed);
+            }
+            framesCaptured_.fetch_add(blockFrames_, std::memory_order_relaxed);
+            if (auto *recorder = recorder_.load(std::memory_order_acquire)) {
+                recorder->push(block.data(), blockFrames_);
+            }
+            // Only push whole blocks so the ring always holds whole frames
+            if (ring_.writeAvailable() < block.size()) {
+                overruns_.fetch_add(1, std::memory_order_relaxed);
+                droppedFrames_.fetch_add(blockFrames_, std::memory_order_relaxed);
+                continue;
+            }
+            ring_.push(block.data(), block.size());
+        }
+    } catch (...) {
+        error_ = std::current_exception();
+        failed_.store(true, std::memory_order_release);
+    }
+}
+
+bool CaptureThread::populateFrame(Frame &frame) {
+    // Only grows when switching to a larger frame than any before
+    if (pending_.size() < frame.numSamples * numChannels_) {
+        pending_.resize(frame.numSamples * numChannels_);
+    }
+    const auto numFrames = popFrames(pending_.data(), frame.numSamples);
+    if (numFrames == 0) {
+        return false;
+    }
+    frame.advance(pending_.data(), numFrames, numChannels_, meter_);
+    frame.finalize();
+    return true;
+}
+
+size_t CaptureThread::pop(S16NESample *interleaved, size_t maxFrames) {
+    const auto numFrames = popFrames(interleaved, maxFrames);
+    if (meter_) {
+        meter_->processInterleaved(interleaved, numFrames);
+    }
+    return numFrames;
+}
+
+size_t CaptureThread::popFrames(S16NESample *interleaved, size_t maxFrames) {
+    if (failed_.load(std::memory_order_acquire)) {
+        std::rethrow_exception(error_);
+    }
+    const auto available = ring_.readAvailable();
+    if (available == 0) {
+        underruns_.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    const auto maxSamples = maxFrames * numChannels_;
+    if (available > maxSamples) {
+        const auto stale = available - maxSamples;
+        if (history_ || meter_) {
+            // The history and meter take everything, so stale audio is read through interleaved rather than discarded
+            for (size_t done = 0; done < stale;) {
+                const auto n = ring_.pop(interleaved, std::min(stale - done, maxSamples));
+                if (history_) {
+                    history_->append(interleaved, n / numChannels_);
+                }
+                if (meter_) {
+                    meter_->processInterleaved(interleaved, n / numChannels_);
+                }
+                done += n;
+            }
+        } else {
+            ring_.discard(stale);
+        }
+        staleFrames_.fetch_add(stale / numChannels_, std::memory_order_relaxed);
+    }
+    const auto numFrames = ring_.pop(interleaved, std::min(available, maxSamples)) / numChannels_;
+    if (history_) {
+        history_->append(interleaved, numFrames);
+    }
+    return numFrames;
+}
+
+CaptureMetrics CaptureThread::metrics() const noexcept {
+    return CaptureMetrics{framesCaptured_.load(std::memory_order_relaxed), overruns_.load(std::memory_order_relaxed),
+                          droppedFrames_.load(std::memory_order_relaxed), underruns_.load(std::memory_order_relaxed),
+                          staleFrames_.load(std::memory_order_relaxed)};
+}
+
+CaptureTiming CaptureThread::newestCapture() const noexcept {
+    const LatencyClock::duration sinceEpoch{newestCaptureTicks_.load(std::memory_order_relaxed)};
+    return CaptureTiming{LatencyClock::time_point{sinceEpoch}, newestSourceLatency_.load(std::memory_order_relaxed)};
+}
+
+} // namespace PulseView
@@ -3,34 +3,282 @@
 // Date: 2020-06-13
 //
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <mutex>
+#include <system_error>
 
 #include <fftw3.h>
 
 #include <fftw_helper.h>
+#include <frame_kernels.h>
+#include <task_pool.h>
 
 namespace PulseView::fftw {
 
-FFTWHelper::FFTWHelper(size_t log2NumSamples)
-    : size{((size_t)1) << log2NumSamples}, fftw_in{size}, fftw_out{size},
-      plan(fftw_plan_dft_1d(size, reinterpret_cast<fftw_complex *>(fftw_in.data()),
-                            reinterpret_cast<fftw_complex *>(fftw_out.data()), FFTW_FORWARD, FFTW_ESTIMATE),
-           fftw_destroy_plan) {}
+namespace {
 
-void FFTWHelper::calculateDFT(const std::vector<double> &in, std::vector<double> &out) {
-    assert(in.size() == size);
-    assert(out.size() == size);
-    assert(fftw_in.size() == size);
-    assert(fftw_out.size() == size);
-    for (auto i = 0u; i < size; ++i) {
-        fftw_in[i].value[0] = in[i];
-        fftw_in[i].value[1] = 0;
+struct PlannerThreads {
+    size_t numThreads{1};
+    size_t minLog2Size{defaultThreadedLog2Size};
+    bool initialised{false};
+};
+
+// FFTW's planner, including destroying plans and its wisdom, isn't thread safe. Frames are planned off the render
+// thread, so everything touching it holds this. Executing plans doesn't.
+std::mutex &plannerMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+PlannerThreads &plannerThreads() {
+    static PlannerThreads threads;
+    return threads;
+}
+
+// How many threads a plan for size points gets
+size_t threadsFor(size_t size) {
+    const auto &threads = plannerThreads();
+    return size >= (size_t{1} << threads.minLog2Size) ? threads.numThreads : 1;
+}
+
+unsigned plannerFlags(PlannerEffort effort) {
+    switch (effort) {
+    case PlannerEffort::Estimate:
+        return FFTW_ESTIMATE;
+    case PlannerEffort::Patient:
+        return FFTW_PATIENT;
+    case PlannerEffort::Measure:
+    default:
+        return FFTW_MEASURE;
+    }
+}
+
+template <typename T> std::string exportWisdom() {
+    std::string wisdom;
+    FFTWTraits<T>::exportWisdom([](char c, void *data) { static_cast<std::string *>(data)->push_back(c); }, &wisdom);
+    return wisdom;
+}
+
+// The wisdom as it was last read from or written to disk, used to skip rewriting the file when a plan was recreated
+// purely from existing wisdom
+template <typename T> std::string &persistedWisdom() {
+    static std::string wisdom;
+    return wisdom;
+}
+
+template <typename T> void importWisdomOnce() {
+    static bool imported = false;
+    if (imported) {
+        return;
+    }
+    imported = true;
+    const auto path = wisdomPath<T>();
+    if (!path.empty() && FFTWTraits<T>::importWisdomFromFilename(path.c_str())) {
+        persistedWisdom<T>() = exportWisdom<T>();
+    }
+}
+
+template <typename T> void saveWisdomIfChanged() {
+    const auto path = wisdomPath<T>();
+    if (path.empty()) {
+        return;
+    }
+    auto wisdom = exportWisdom<T>();
+    if (wisdom == persistedWisdom<T>()) {
+        return;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path{path}.parent_path(), ec);
+    if (ec || !FFTWTraits<T>::exportWisdomToFilename(path.c_str())) {
+        std::cerr << "Failed to save FFTW wisdom to " << path << '\n';
+        return;
+    }
+    persistedWisdom<T>() = std::move(wisdom);
+}
+
+template <typename T>
+typename FFTWTraits<T>::PlanStruct *createPlan(size_t size, size_t numChannels, T *in, size_t binStride,
+                                               BasicFFTWComplex<T> *out, PlannerEffort effort) {
+    if (numChannels == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock{plannerMutex()};
+    importWisdomOnce<T>();
+    // The thread count is global planner state, so it's set for every plan once threads are in use
+    if (plannerThreads().initialised) {
+        FFTWTraits<T>::planWithNthreads(static_cast<int>(threadsFor(size)));
+    }
+    const int n[] = {static_cast<int>(size)};
+    auto plan = FFTWTraits<T>::planManyR2C(1, n, numChannels, in, nullptr, 1, size,
+                                           reinterpret_cast<typename FFTWTraits<T>::Complex *>(out), nullptr, 1,
+                                           binStride, plannerFlags(effort));
+    saveWisdomIfChanged<T>();
+    return plan;
+}
+
+template <typename T> void destroyPlan(typename FFTWTraits<T>::PlanStruct *plan) {
+    if (plan) {
+        std::lock_guard<std::mutex> lock{plannerMutex()};
+        FFTWTraits<T>::destroyPlan(plan);
+    }
+}
+
+// Below this many channels splitting the transform costs more in dispatch than it saves
+constexpr size_t minParallelChannels = 4;
+// Each group gets at least this many channels, so batching still pays off within a group
+constexpr size_t minGroupChannels = 2;
+
+size_t groupSizeFor(size_t numChannels, size_t size) {
+    if (numChannels == 0) {
+        die("Can't transform zero channels");
     }
-    fftw_execute(&*plan);
-    for (auto i = 0u; i < size; ++i) {
-        out[i] = fftw_out[i].value[0];
+    // Multithreaded plans already keep every thread busy
+    if (numChannels < minParallelChannels || threadsFor(size) > 1) {
+        return numChannels;
+    }
+    const auto numGroups =
+        std::max<size_t>(1, std::min(TaskPool::shared().numThreads() + 1, numChannels / minGroupChannels));
+    return (numChannels + numGroups - 1) / numGroups;
+}
+
+} // namespace
+
+const char *windowFunctionName(WindowFunction window) noexcept {
+    switch (window) {
+    case WindowFunction::Rectangular:
+        return "rectangular";
+    case WindowFunction::Hann:
+        return "hann";
+    case WindowFunction::Hamming:
+        return "hamming";
+    case WindowFunction::Blackman:
+        return "blackman";
     }
+    return "";
 }
 
+void setPlannerThreads(size_t numThreads, size_t minLog2Size) {
+    std::lock_guard<std::mutex> lock{plannerMutex()};
+    auto &threads = plannerThreads();
+    if (numThreads > 1 && !threads.initialised) {
+        if (!FFTWTraits<double>::initThreads() || !FFTWTraits<float>::initThreads()) {
+            die("Failed to initialise FFTW threads");
+        }
+        threads.initialised = true;
+    }
+    threads.numThreads = std::max<size_t>(numThreads, 1);
+    threads.minLog2Size = minLog2Size;
+}
+
+template <typename T> std::string wisdomPath() {
+    if (const char *path = std::getenv(FFTWTraits<T>::wisdomEnv)) {
+        return path;
+    }
+    std::string cacheDir;
+    if (const char *xdgCache = std::getenv("XDG_CACHE_HOME"); xdgCache && *xdgCache) {
+        cacheDir = xdgCache;
+    } else if (const char *home = std::getenv("HOME"); home && *home) {
+        cacheDir = std::string{home} + "/.cache";
+    } else {
+        return {};
+    }
+    return cacheDir + "/pulseview/" + FFTWTraits<T>::wisdomFile;
+}
+
+template <typename T>
+BasicFFTWHelper<T>::BasicFFTWHelper(size_t log2NumSamples, size_t numChannels, SpectrumMode mode,
+                                    PlannerEffort effort)
+    : size{((size_t)1) << log2NumSamples}, numBins{size / 2 + 1}, numChannels{numChannels}, mode{mode},
+      binStride{cacheLineStride<Complex>(numBins)}, channelsPerGroup{groupSizeFor(numChannels, size)},
+      numGroups{(numChannels + channelsPerGroup - 1) / channelsPerGroup},
+      kernels{&kernels::frameKernels<T>(log2NumSamples, numChannels)}, fftw_in(numChannels * size),
+      fftw_out(numChannels * binStride),
+      plan(createPlan<T>(size, channelsPerGroup, fftw_in.data(), binStride, fftw_out.data(), effort),
+           destroyPlan<T>),
+      tailPlan(createPlan<T>(size, numChannels % channelsPerGroup, fftw_in.data(), binStride, fftw_out.data(), effort),
+               destroyPlan<T>) {}
+
+template <typename T> void BasicFFTWHelper<T>::setWindow(WindowFunction newWindow) {
+    if (newWindow == window) {
+        return;
+    }
+    window = newWindow;
+    if (window == WindowFunction::Rectangular) {
+        windowCoefficients.clear();
+        return;
+    }
+    windowCoefficients.resize(size);
+    windowed.resize(fftw_in.size());
+    // Periodic rather than symmetric, as the transform treats its input as one period
+    constexpr double tau = 2. * M_PI;
+    double sum = 0.;
+    for (size_t i = 0; i < size; ++i) {
+        const double phase = tau * i / size;
+        double w;
+        switch (window) {
+        case WindowFunction::Hann:
+            w = .5 - .5 * std::cos(phase);
+            break;
+        case WindowFunction::Hamming:
+            w = .54 - .46 * std::cos(phase);
+            break;
+        case WindowFunction::Blackman:
+        default:
+            w = .42 - .5 * std::cos(phase) + .08 * std::cos(2. * phase);
+            break;
+        }
+        windowCoefficients[i] = w;
+        sum += w;
+    }
+    const auto gain = sum / size;
+    for (auto &w : windowCoefficients) {
+        w /= gain;
+    }
+}
+
+template <typename T> void BasicFFTWHelper<T>::transformGroup(size_t group, T *out, size_t outStride) {
+    const auto first = group * channelsPerGroup;
+    const auto last = std::min(first + channelsPerGroup, numChannels);
+    T *in = fftw_in.data() + first * size;
+    if (!windowCoefficients.empty()) {
+        const auto *coefficients = windowCoefficients.data();
+        for (auto c = first; c < last; ++c) {
+            kernels->window(fftw_in.data() + c * size, coefficients, size, windowed.data() + c * size);
+        }
+        in = windowed.data() + first * size;
+    }
+    if (numGroups == 1 && windowCoefficients.empty()) {
+        Traits::execute(&*plan);
+    } else {
+        // Every group's arrays have the alignment the plans were made with, as rows are whole cache lines apart and
+        // windowed is allocated like fftw_in
+        auto &groupPlan = last - first == channelsPerGroup ? plan : tailPlan;
+        Traits::executeR2C(&*groupPlan, in,
+                           reinterpret_cast<typename Traits::Complex *>(fftw_out.data() + first * binStride));
+    }
+    const auto spectrum = mode == SpectrumMode::Power ? kernels->power : kernels->magnitude;
+    for (auto c = first; c < last; ++c) {
+        spectrum(fftw_out.data() + c * binStride, size, out + c * outStride);
+    }
+}
+
+template <typename T> void BasicFFTWHelper<T>::calculateDFT(T *out, size_t outStride) {
+    assert(outStride >= numBins);
+    if (numGroups == 1) {
+        transformGroup(0, out, outStride);
+        return;
+    }
+    TaskPool::shared().parallelFor(numGroups, [&](size_t group) { transformGroup(group, out, outStride); });
+}
+
+template std::string wisdomPath<double>();
+template std::string wisdomPath<float>();
+template struct BasicFFTWHelper<double>;
+template struct BasicFFTWHelper<float>;
+
 } // namespace PulseView::fftw
@@ -0,0 +1,131 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_source.h"
+
+namespace PulseView::AudioSource {
+
+namespace {
+
+// WAV fields are little endian, samples are assumed to already be in host order (S16NE)
+uint32_t readLE32(const unsigned char *p) noexcept { return p[0] | p[1] << 8 | p[2] << 16 | uint32_t(p[3]) << 24; }
+uint16_t readLE16(const unsigned char *p) noexcept { return p[0] | p[1] << 8; }
+
+constexpr uint16_t wavFormatPCM = 1;
+constexpr uint16_t wavFormatExtensible = 0xFFFE;
+
+} // namespace
+
+FileSource::FileSource(const std::string &path, size_t rawSampleRate, size_t rawChannels)
+    : numChannels_{rawChannels}, sampleRate_{rawSampleRate} {
+    if (numChannels_ < 1) {
+        die("Raw input needs at least one channel");
+    }
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        PulseView::fail_errno("Failed to open " + path + ": ");
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        PulseView::fail_errno("Failed to stat " + path + ": ");
+    }
+    mapSize_ = st.st_size;
+    if (mapSize_ > 0) {
+        map_ = mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        PulseView::fail_errno("Failed to mmap " + path + ": ");
+    }
+    // The file is consumed front to back exactly once
+    if (map_) {
+        madvise(map_, mapSize_, MADV_SEQUENTIAL);
+    }
+
+    const auto *data = static_cast<const unsigned char *>(map_);
+    try {
+        if (mapSize_ >= 12 && !memcmp(data, "RIFF", 4) && !memcmp(data + 8, "WAVE", 4)) {
+            parseWav(data, mapSize_);
+        } else {
+            samples_ = data;
+            numFrames_ = mapSize_ / (numChannels_ * sizeof(S16NESample));
+        }
+    } catch (...) {
+        munmap(map_, mapSize_);
+        throw;
+    }
+}
+
+FileSource::~FileSource() noexcept {
+    if (map_) {
+        munmap(map_, mapSize_);
+        map_ = nullptr;
+    }
+}
+
+void FileSource::parseWav(const unsigned char *data, size_t size) {
+    bool haveFormat = false;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const auto *chunk = data + offset;
+        const size_t chunkSize = readLE32(chunk + 4);
+        const auto *body = chunk + 8;
+        const size_t available = std::min(chunkSize, size - offset - 8);
+        if (!memcmp(chunk, "fmt ", 4)) {
+            if (available < 16) {
+                die("Truncated WAV fmt chunk");
+            }
+            const auto format = readLE16(body);
+            numChannels_ = readLE16(body + 2);
+            sampleRate_ = readLE32(body + 4);
+            const auto bitsPerSample = readLE16(body + 14);
+            if ((format != wavFormatPCM && format != wavFormatExtensible) || bitsPerSample != 16) {
+                die("Only 16 bit PCM WAV files are supported");
+            }
+            if (numChannels_ < 1) {
+                die("WAV file has no channels");
+            }
+            haveFormat = true;
+        } else if (!memcmp(chunk, "data", 4)) {
+            if (!haveFormat) {
+                die("WAV data chunk precedes its fmt chunk");
+            }
+            // Streamed WAVs leave the data size at its maximum, so trust the file length over the header
+            samples_ = body;
+            numFrames_ = available / (numChannels_ * sizeof(S16NESample));
+            return;
+        }
+        // Chunks are padded to an even length
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+    die("WAV file has no data chunk");
+}
+
+void FileSource::populateFrame(PulseView::Frame &frame) {
+    buffer_.resize(numChannels_ * frame.numSamples);
+    read(buffer_.data(), frame.numSamples);
+    frame.loadInterleaved(buffer_.data(), numChannels_);
+    frame.finalize();
+}
+
+void FileSource::read(PulseView::S16NESample *buffer, size_t numFrames) {
+    const auto numRead = std::min(numFrames, numFrames_ - std::min(position_, numFrames_));
+    const auto frameBytes = numChannels_ * sizeof(S16NESample);
+    memcpy(buffer, samples_ + position_ * frameBytes, numRead * frameBytes);
+    std::fill(buffer + numRead * numChannels_, buffer + numFrames * numChannels_, S16NESample{0});
+    position_ += numFrames;
+}
+
+} // namespace PulseView::AudioSource
@@ -0,0 +1,110 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <atomic>
+
+#include "frame_cache.h"
+#include "task_pool.h"
+
+namespace PulseView {
+
+namespace {
+
+uint64_t nextGeneration() noexcept {
+    static std::atomic<uint64_t> generation{0};
+    return ++generation;
+}
+
+} // namespace
+
+std::shared_ptr<FrameSet> PendingFrameSet::ready() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return set_;
+}
+
+FrameCache::FrameCache(size_t numChannels, size_t framesPerSet, size_t capacity)
+    : numChannels_{numChannels}, framesPerSet_{framesPerSet}, capacity_{capacity} {}
+
+FrameCache::~FrameCache() noexcept {
+    std::unique_lock<std::mutex> lock{mutex_};
+    jobs_.clear();
+    idle_.wait(lock, [this] { return !running_; });
+}
+
+std::shared_ptr<FrameSet> FrameCache::acquire(size_t log2Size, fftw::WindowFunction window,
+                                              fftw::PlannerEffort effort) {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto it = std::find_if(sets_.begin(), sets_.end(), [&](const auto &s) { return s->log2Size == log2Size; });
+        if (it != sets_.end()) {
+            ++metrics_.hits;
+            std::rotate(sets_.begin(), it, it + 1);
+            return sets_.front();
+        }
+        ++metrics_.misses;
+    }
+    // Planned and allocated without holding the lock, so contains() and metrics() never wait on it
+    auto set = std::make_shared<FrameSet>();
+    set->log2Size = log2Size;
+    set->generation = nextGeneration();
+    for (size_t i = 0; i < framesPerSet_; ++i) {
+        set->frames.push_back(std::make_unique<Frame>(log2Size, numChannels_, effort));
+        set->frames.back()->setWindow(window);
+    }
+    std::shared_ptr<FrameSet> evicted;
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (sets_.size() >= capacity_) {
+        // Freed once the lock is released, if nobody else holds it
+        evicted = std::move(sets_.back());
+        sets_.pop_back();
+        ++metrics_.evictions;
+    }
+    sets_.insert(sets_.begin(), set);
+    return set;
+}
+
+std::shared_ptr<PendingFrameSet> FrameCache::prepare(size_t log2Size, fftw::WindowFunction window, Prepare then) {
+    std::shared_ptr<PendingFrameSet> pending{new PendingFrameSet{log2Size}};
+    std::lock_guard<std::mutex> lock{mutex_};
+    jobs_.push_back(Job{pending, window, std::move(then)});
+    if (!running_) {
+        running_ = true;
+        TaskPool::shared().post([this] { runJobs(); });
+    }
+    return pending;
+}
+
+void FrameCache::runJobs() noexcept {
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (!jobs_.empty()) {
+        auto job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        auto set = acquire(job.pending->log2Size(), job.window);
+        if (job.then) {
+            job.then(*set);
+        }
+        {
+            std::lock_guard<std::mutex> pendingLock{job.pending->mutex_};
+            job.pending->set_ = std::move(set);
+        }
+        lock.lock();
+    }
+    running_ = false;
+    idle_.notify_all();
+}
+
+bool FrameCache::contains(size_t log2Size) const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return std::any_of(sets_.begin(), sets_.end(), [&](const auto &s) { return s->log2Size == log2Size; });
+}
+
+FrameCacheMetrics FrameCache::metrics() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return metrics_;
+}
+
+} // namespace PulseView
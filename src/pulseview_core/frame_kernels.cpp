@@ -0,0 +1,194 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "frame_kernels.h"
+#include "sample_conversion.h"
+
+namespace PulseView::kernels {
+
+namespace {
+
+template <typename T> MinMax<T> minMaxScalar(const T *samples, size_t n, size_t start, MinMax<T> rv) noexcept {
+    for (size_t i = start; i < n; ++i) {
+        rv.min = std::min(rv.min, samples[i]);
+        rv.max = std::max(rv.max, samples[i]);
+    }
+    return rv;
+}
+
+} // namespace
+
+MinMax<double> minMax(const double *samples, size_t n) noexcept {
+    size_t i = 0;
+    MinMax<double> rv{samples[0], samples[0]};
+#ifdef __SSE2__
+    if (n >= 4) {
+        __m128d lo = _mm_loadu_pd(samples);
+        __m128d hi = lo;
+        for (; i + 4 <= n; i += 4) {
+            const __m128d a = _mm_loadu_pd(samples + i);
+            const __m128d b = _mm_loadu_pd(samples + i + 2);
+            lo = _mm_min_pd(lo, _mm_min_pd(a, b));
+            hi = _mm_max_pd(hi, _mm_max_pd(a, b));
+        }
+        lo = _mm_min_sd(lo, _mm_unpackhi_pd(lo, lo));
+        hi = _mm_max_sd(hi, _mm_unpackhi_pd(hi, hi));
+        rv = MinMax<double>{_mm_cvtsd_f64(lo), _mm_cvtsd_f64(hi)};
+    }
+#endif
+    return minMaxScalar(samples, n, i, rv);
+}
+
+MinMax<float> minMax(const float *samples, size_t n) noexcept {
+    size_t i = 0;
+    MinMax<float> rv{samples[0], samples[0]};
+#ifdef __SSE2__
+    if (n >= 8) {
+        __m128 lo = _mm_loadu_ps(samples);
+        __m128 hi = lo;
+        for (; i + 8 <= n; i += 8) {
+            const __m128 a = _mm_loadu_ps(samples + i);
+            const __m128 b = _mm_loadu_ps(samples + i + 4);
+            lo = _mm_min_ps(lo, _mm_min_ps(a, b));
+            hi = _mm_max_ps(hi, _mm_max_ps(a, b));
+        }
+        lo = _mm_min_ps(lo, _mm_movehl_ps(lo, lo));
+        hi = _mm_max_ps(hi, _mm_movehl_ps(hi, hi));
+        lo = _mm_min_ss(lo, _mm_shuffle_ps(lo, lo, 1));
+        hi = _mm_max_ss(hi, _mm_shuffle_ps(hi, hi, 1));
+        rv = MinMax<float>{_mm_cvtss_f32(lo), _mm_cvtss_f32(hi)};
+    }
+#endif
+    return minMaxScalar(samples, n, i, rv);
+}
+
+namespace {
+
+// Stands in for a size or channel count that's only known at runtime
+constexpr size_t dynamicExtent = 0;
+
+template <size_t Log2Size> constexpr size_t sizeOr(size_t size) noexcept {
+    return Log2Size == dynamicExtent ? size : size_t{1} << Log2Size;
+}
+
+// Rows of every specialised size start on cache lines, telling the compiler so spares it peeling iterations to reach an
+// aligned address. Rows of generic sizes below a cache line's worth of samples needn't.
+template <size_t Log2Size, typename T> T *assumeAligned(T *p) noexcept {
+    if constexpr (Log2Size == dynamicExtent) {
+        return p;
+    } else {
+        static_assert((sizeof(T) << Log2Size) % fftw::cacheLineSize == 0);
+        return static_cast<T *>(__builtin_assume_aligned(p, fftw::cacheLineSize));
+    }
+}
+
+template <typename T, size_t NumChannels>
+void load(const S16NESample *interleaved, size_t size, size_t numChannels, T *const *out) {
+    // Mono and stereo already have SIMD kernels picked for the CPU at runtime, which the generic kernel also uses
+    if constexpr (NumChannels == dynamicExtent || NumChannels <= 2) {
+        conversion::deinterleave(interleaved, conversion::SampleFormat::S16NE, numChannels, size, out);
+    } else {
+        constexpr T scale = std::numeric_limits<S16NESample>::max();
+        T *rows[NumChannels];
+        for (size_t c = 0; c < NumChannels; ++c) {
+            rows[c] = assumeAligned<minSpecialisedLog2Size>(out[c]);
+        }
+        for (size_t i = 0; i < size; ++i) {
+            for (size_t c = 0; c < NumChannels; ++c) {
+                rows[c][i] = static_cast<T>(interleaved[NumChannels * i + c]) / scale;
+            }
+        }
+    }
+}
+
+template <typename T, size_t Log2Size> void window(const T *samples, const T *coefficients, size_t size, T *out) {
+    size = sizeOr<Log2Size>(size);
+    samples = assumeAligned<Log2Size>(samples);
+    coefficients = assumeAligned<Log2Size>(coefficients);
+    out = assumeAligned<Log2Size>(out);
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = samples[i] * coefficients[i];
+    }
+}
+
+template <typename T, size_t Log2Size>
+void magnitude(const typename FrameKernels<T>::Complex *bins, size_t size, T *out) {
+    const auto numBins = sizeOr<Log2Size>(size) / 2 + 1;
+    bins = assumeAligned<Log2Size>(bins);
+    out = assumeAligned<Log2Size>(out);
+    for (size_t i = 0; i < numBins; ++i) {
+        const auto &v = bins[i].value;
+        out[i] = std::sqrt(v[0] * v[0] + v[1] * v[1]);
+    }
+}
+
+template <typename T, size_t Log2Size> void power(const typename FrameKernels<T>::Complex *bins, size_t size, T *out) {
+    const auto numBins = sizeOr<Log2Size>(size) / 2 + 1;
+    bins = assumeAligned<Log2Size>(bins);
+    out = assumeAligned<Log2Size>(out);
+    for (size_t i = 0; i < numBins; ++i) {
+        const auto &v = bins[i].value;
+        out[i] = v[0] * v[0] + v[1] * v[1];
+    }
+}
+
+template <typename T, size_t Log2Size>
+void envelope(const T *samples, size_t size, size_t numColumns, T *mins, T *maxs) {
+    size = sizeOr<Log2Size>(size);
+    for (size_t x = 0; x < numColumns; ++x) {
+        auto i1 = (x * size) / numColumns;
+        auto i2 = std::min(((x + 1) * size) / numColumns, size - 1);
+        const auto range = minMax(samples + i1, i2 - i1 + 1);
+        mins[x] = range.min;
+        maxs[x] = range.max;
+    }
+}
+
+template <typename T, size_t Log2Size, size_t NumChannels> constexpr FrameKernels<T> makeKernels() noexcept {
+    return FrameKernels<T>{load<T, NumChannels>,  window<T, Log2Size>,   magnitude<T, Log2Size>,
+                           power<T, Log2Size>,    envelope<T, Log2Size>, Log2Size != dynamicExtent};
+}
+
+constexpr size_t numSpecialisedCounts = specialisedChannelCounts.size();
+constexpr size_t numSpecialised = (maxSpecialisedLog2Size - minSpecialisedLog2Size + 1) * numSpecialisedCounts;
+
+// Entry i is for size 2^(minSpecialisedLog2Size + i / numSpecialisedCounts) and the (i % numSpecialisedCounts)th count
+template <typename T, size_t... I>
+constexpr std::array<FrameKernels<T>, sizeof...(I)> makeTable(std::index_sequence<I...>) noexcept {
+    return {makeKernels<T, minSpecialisedLog2Size + I / numSpecialisedCounts,
+                        specialisedChannelCounts[I % numSpecialisedCounts]>()...};
+}
+
+template <typename T>
+constexpr std::array<FrameKernels<T>, numSpecialised> specialisedKernels =
+    makeTable<T>(std::make_index_sequence<numSpecialised>{});
+
+template <typename T> constexpr FrameKernels<T> genericKernels = makeKernels<T, dynamicExtent, dynamicExtent>();
+
+} // namespace
+
+template <typename T> const FrameKernels<T> &frameKernels(size_t log2Size, size_t numChannels) noexcept {
+    if (log2Size >= minSpecialisedLog2Size && log2Size <= maxSpecialisedLog2Size) {
+        for (size_t c = 0; c < numSpecialisedCounts; ++c) {
+            if (specialisedChannelCounts[c] == numChannels) {
+                return specialisedKernels<T>[(log2Size - minSpecialisedLog2Size) * numSpecialisedCounts + c];
+            }
+        }
+    }
+    return genericKernels<T>;
+}
+
+template const FrameKernels<double> &frameKernels(size_t log2Size, size_t numChannels) noexcept;
+template const FrameKernels<float> &frameKernels(size_t log2Size, size_t numChannels) noexcept;
+
+} // namespace PulseView::kernels
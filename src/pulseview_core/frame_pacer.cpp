@@ -0,0 +1,92 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "frame_pacer.h"
+
+namespace PulseView {
+
+void FramePacer::setPeriod(uint64_t periodMicros, bool sleep) noexcept {
+    periodMicros_ = periodMicros;
+    sleep_ = sleep;
+    deadline_ = {};
+}
+
+void FramePacer::setAdaptive(bool adaptive) noexcept {
+    adaptive_ = adaptive;
+    if (!adaptive_) {
+        setQuality(RenderQuality::Full);
+    }
+}
+
+void FramePacer::setLowestQuality(RenderQuality quality) noexcept {
+    lowestQuality_ = quality;
+    setQuality(std::min(quality_, lowestQuality_));
+}
+
+void FramePacer::setQuality(RenderQuality quality) noexcept {
+    quality_ = quality;
+    overBudgetRun_ = underBudgetRun_ = 0;
+}
+
+void FramePacer::waitForNextFrame() {
+    const auto now = LatencyClock::now();
+    const std::chrono::microseconds period{periodMicros_};
+    if (deadline_ == LatencyClock::time_point{}) {
+        deadline_ = now + period;
+        return;
+    }
+    if (now < deadline_) {
+        if (sleep_ || lastSkipped_) {
+            std::this_thread::sleep_until(deadline_);
+        }
+        deadline_ += period;
+        return;
+    }
+    // Rather than rushing through frames to catch up, start the schedule again from now
+    if (now - deadline_ >= period) {
+        ++metrics_.missedDeadlines;
+        deadline_ = now + period;
+    } else {
+        deadline_ += period;
+    }
+}
+
+void FramePacer::frameSkipped() noexcept {
+    ++metrics_.framesSkipped;
+    lastSkipped_ = true;
+}
+
+bool FramePacer::frameRendered(uint64_t workMicros) noexcept {
+    ++metrics_.framesRendered;
+    ++metrics_.framesAtQuality[static_cast<size_t>(quality_)];
+    lastSkipped_ = false;
+    if (workMicros > periodMicros_) {
+        ++metrics_.overBudget;
+        underBudgetRun_ = 0;
+        if (adaptive_ && quality_ < lowestQuality_ && ++overBudgetRun_ >= overBudgetToDegrade) {
+            setQuality(static_cast<RenderQuality>(static_cast<size_t>(quality_) + 1));
+            ++metrics_.degradations;
+            return true;
+        }
+        return false;
+    }
+    overBudgetRun_ = 0;
+    if (workMicros * 2 > periodMicros_ || quality_ == RenderQuality::Full) {
+        underBudgetRun_ = 0;
+        return false;
+    }
+    if (++underBudgetRun_ >= underBudgetToRecover) {
+        setQuality(static_cast<RenderQuality>(static_cast<size_t>(quality_) - 1));
+        ++metrics_.recoveries;
+        return true;
+    }
+    return false;
+}
+
+} // namespace PulseView
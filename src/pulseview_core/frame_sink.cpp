@@ -0,0 +1,58 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "frame_sink.h"
+
+namespace PulseView {
+
+PNGSequenceSink::PNGSequenceSink(std::string directory) : directory_{std::move(directory)} {
+    std::filesystem::create_directories(directory_);
+}
+
+void PNGSequenceSink::write(const sf::Image &image) {
+    char name[32];
+    snprintf(name, sizeof(name), "/frame-%06zu.png", frameIndex_++);
+    if (!image.saveToFile(directory_ + name)) {
+        throw std::runtime_error("Failed to write " + directory_ + name);
+    }
+}
+
+RawVideoSink::RawVideoSink(const std::string &path) : fd_{STDOUT_FILENO}, ownsFD_{path != "-"} {
+    if (ownsFD_) {
+        fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            PulseView::fail_errno("Failed to open " + path + ": ");
+        }
+    }
+}
+
+RawVideoSink::~RawVideoSink() noexcept {
+    if (ownsFD_) {
+        close(fd_);
+    }
+}
+
+void RawVideoSink::write(const sf::Image &image) {
+    const auto size = image.getSize();
+    const auto *bytes = reinterpret_cast<const char *>(image.getPixelsPtr());
+    const size_t bytesToWrite = size_t{size.x} * size.y * 4;
+    size_t bytesWritten{0};
+    while (bytesWritten < bytesToWrite) {
+        ssize_t writeResult = ::write(fd_, bytes + bytesWritten, bytesToWrite - bytesWritten);
+        if (writeResult < 0) {
+            PulseView::fail_errno("Failed to write() raw video: ");
+        } else {
+            bytesWritten += writeResult;
+        }
+    }
+}
+
+} // namespace PulseView
@@ -0,0 +1,99 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+
+#include "frame_switcher.h"
+
+namespace PulseView {
+
+FrameSwitcher::FrameSwitcher(CaptureThread &capture, Frame &frame)
+    : capture_{capture}, frame_{frame}, frames_{frame.numChannels}, windowFunction_{frame.fftw.window},
+      ownHistory_{std::make_unique<SignalHistory>(frame.numChannels, size_t{1} << maxLog2FrameSize)},
+      history_{ownHistory_.get()} {
+    capture_.setHistory(history_);
+}
+
+void FrameSwitcher::setHistory(SignalHistory *history) {
+    history_ = history;
+    capture_.setHistory(history_);
+    ownHistory_.reset();
+    // Its seed counts frames of the old history, so it's prepared again
+    pending_.reset();
+}
+
+bool FrameSwitcher::update(size_t log2Size) {
+    if (log2Size == frame_.log2Size) {
+        // Always ready
+        pending_.reset();
+        set_.reset();
+    } else if (set_ && set_->log2Size == log2Size) {
+        pending_.reset();
+    } else if (!pending_ || pending_->log2Size() != log2Size) {
+        prepare(log2Size);
+    } else if (auto set = pending_->ready()) {
+        pending_.reset();
+        set_ = std::move(set);
+        catchUp(*set_->frames.front(), pendingSeededAt_);
+    }
+    const auto &frame = current();
+    const auto generation = set_ ? set_->generation : 0;
+    if (frame.log2Size == currentLog2Size_ && generation == currentGeneration_) {
+        return false;
+    }
+    if (!set_) {
+        // Seeding the frame passed to the constructor is the one thing done here rather than in the background
+        seed(frame_);
+    }
+    currentLog2Size_ = frame.log2Size;
+    currentGeneration_ = generation;
+    return true;
+}
+
+void FrameSwitcher::setWindowFunction(fftw::WindowFunction window) {
+    windowFunction_ = window;
+    frame_.setWindow(window);
+    if (set_) {
+        set_->frames.front()->setWindow(window);
+    }
+    if (pending_) {
+        prepare(pending_->log2Size());
+    }
+}
+
+void FrameSwitcher::prepare(size_t log2Size) {
+    const auto numFrames = size_t{1} << log2Size;
+    // Copied here, as the history is only ever touched on this thread
+    std::vector<S16NESample> newest(numFrames * frame_.numChannels);
+    history_->copyNewest(newest.data(), numFrames);
+    pendingSeededAt_ = history_->framesWritten();
+    const auto window = windowFunction_;
+    pending_ = frames_.prepare(log2Size, window, [newest = std::move(newest), window](FrameSet &set) {
+        auto &frame = *set.frames.front();
+        frame.setWindow(window);
+        frame.loadInterleaved(newest.data(), frame.numChannels);
+        frame.finalize();
+    });
+}
+
+void FrameSwitcher::seed(Frame &frame) {
+    seed_.resize(frame.numSamples * frame.numChannels);
+    history_->copyNewest(seed_.data(), frame.numSamples);
+    frame.loadInterleaved(seed_.data(), frame.numChannels);
+    frame.finalize();
+}
+
+// Only converts what was missed, the transform follows with the next audio
+void FrameSwitcher::catchUp(Frame &frame, uint64_t seededAt) {
+    const auto missed = std::min<uint64_t>(history_->framesWritten() - seededAt, frame.numSamples);
+    if (missed == 0) {
+        return;
+    }
+    seed_.resize(missed * frame.numChannels);
+    history_->copyNewest(seed_.data(), missed);
+    frame.advance(seed_.data(), missed, frame.numChannels);
+}
+
+} // namespace PulseView
@@ -0,0 +1,92 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <cinttypes>
+#include <stdexcept>
+
+#include "frame_trace.h"
+#include "pulseview.h"
+
+namespace PulseView {
+
+namespace {
+
+constexpr Stage renderStages[] = {Stage::Capture, Stage::Events, Stage::Draw, Stage::Display};
+constexpr Stage audioStages[] = {Stage::SourceLatency, Stage::AudioToPhoton};
+// The CSV columns start after it
+static_assert(static_cast<size_t>(Stage::SourceRead) == 0);
+
+// Stage names with spaces swapped for underscores, so they work as CSV column names
+void writeColumnName(FILE *file, Stage stage) {
+    for (const char *c = stageName(stage); *c; ++c) {
+        fputc(*c == ' ' ? '_' : *c, file);
+    }
+    fputs("_us", file);
+}
+
+} // namespace
+
+FrameTrace::FrameTrace(const std::string &path, TraceFormat format)
+    : file_{fopen(path.c_str(), "w")}, format_{format}, opened_{LatencyClock::now()} {
+    if (!file_) {
+        PulseView::fail_errno("Failed to open " + path + ": ");
+    }
+    if (format_ == TraceFormat::CSV) {
+        fputs("frame,start_us", file_);
+        // Reads happen on the capture thread and don't line up with frames, so they're only in the histograms
+        for (size_t s = 1; s < numStages; ++s) {
+            fputc(',', file_);
+            writeColumnName(file_, static_cast<Stage>(s));
+        }
+        fputc('\n', file_);
+    } else {
+        fputs("{\"traceEvents\":[\n", file_);
+    }
+}
+
+FrameTrace::~FrameTrace() noexcept {
+    if (format_ == TraceFormat::ChromeTrace) {
+        fputs("\n]}\n", file_);
+    }
+    fclose(file_);
+}
+
+uint64_t FrameTrace::sinceOpened(LatencyClock::time_point t) const noexcept { return toMicros(t - opened_); }
+
+void FrameTrace::record(const FrameTiming &timing) {
+    const auto frameStart = sinceOpened(timing.start[static_cast<size_t>(Stage::Frame)]);
+    if (format_ == TraceFormat::CSV) {
+        fprintf(file_, "%" PRIu64 ",%" PRIu64, timing.index, frameStart);
+        for (size_t s = 1; s < numStages; ++s) {
+            const auto stage = static_cast<Stage>(s);
+            if (timing.hasAudio || (stage != Stage::SourceLatency && stage != Stage::AudioToPhoton)) {
+                fprintf(file_, ",%" PRIu64, timing.micros[s]);
+            } else {
+                fputc(',', file_);
+            }
+        }
+        fputc('\n', file_);
+        return;
+    }
+    const char *separator = first_ ? "" : ",\n";
+    first_ = false;
+    fprintf(file_, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 "}",
+            separator, frameStart, timing.micros[static_cast<size_t>(Stage::Frame)]);
+    for (auto stage : renderStages) {
+        const auto s = static_cast<size_t>(stage);
+        fprintf(file_, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 "}",
+                stageName(stage), sinceOpened(timing.start[s]), timing.micros[s]);
+    }
+    if (timing.hasAudio) {
+        for (auto stage : audioStages) {
+            fprintf(file_,
+                    ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%" PRIu64 ",\"args\":{\"us\":%" PRIu64
+                    "}}",
+                    stageName(stage), frameStart, timing.micros[static_cast<size_t>(stage)]);
+        }
+    }
+}
+
+} // namespace PulseView
@@ -0,0 +1,90 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#include "latency_overlay.h"
+
+namespace PulseView {
+
+namespace {
+
+constexpr float margin = 8.f;
+constexpr float rowHeight = 16.f;
+constexpr float labelWidth = 320.f;
+constexpr float barAreaWidth = 240.f;
+constexpr unsigned fontSize = 12;
+
+} // namespace
+
+bool LatencyOverlay::loadFont(const std::string &path) {
+    haveFont_ = font_.loadFromFile(path);
+    if (haveFont_) {
+        label_.setFont(font_);
+        label_.setCharacterSize(fontSize);
+        label_.setFillColor(budgetColor);
+    }
+    return haveFont_;
+}
+
+void LatencyOverlay::addBar(size_t row, float left, float width, sf::Color color) {
+    const float top = margin + row * rowHeight + 2.f;
+    const float bottom = top + rowHeight - 4.f;
+    quads_.append(sf::Vertex(sf::Vector2f(left, top), color));
+    quads_.append(sf::Vertex(sf::Vector2f(left + width, top), color));
+    quads_.append(sf::Vertex(sf::Vector2f(left + width, bottom), color));
+    quads_.append(sf::Vertex(sf::Vector2f(left, bottom), color));
+}
+
+void LatencyOverlay::draw(sf::RenderTarget &target, const LatencyStats &stats) {
+    if (!fontTried_) {
+        fontTried_ = true;
+        if (!loadFont(fontPath_)) {
+            std::cerr << "Couldn't load " << fontPath_ << ", the latency overlay will have no labels\n";
+        }
+    }
+    const float barsLeft = margin + (haveFont_ ? labelWidth : 0.f);
+    // The budget sits halfway along, so overruns up to twice the budget stay visible
+    const float pixelsPerMicro = barAreaWidth / (2.f * frameBudgetMicros_);
+    auto barWidth = [&](uint64_t micros) { return std::min(barAreaWidth, micros * pixelsPerMicro); };
+
+    quads_.clear();
+    const float panelWidth = barsLeft + barAreaWidth + margin;
+    const float panelHeight = 2 * margin + numStages * rowHeight;
+    quads_.append(sf::Vertex(sf::Vector2f(0, 0), panelColor));
+    quads_.append(sf::Vertex(sf::Vector2f(panelWidth, 0), panelColor));
+    quads_.append(sf::Vertex(sf::Vector2f(panelWidth, panelHeight), panelColor));
+    quads_.append(sf::Vertex(sf::Vector2f(0, panelHeight), panelColor));
+    for (size_t s = 0; s < numStages; ++s) {
+        const auto &histogram = stats[static_cast<Stage>(s)];
+        addBar(s, barsLeft, barWidth(histogram.max()), maxColor);
+        addBar(s, barsLeft, barWidth(histogram.percentile(0.99)), p99Color);
+        addBar(s, barsLeft, barWidth(histogram.percentile(0.5)), p50Color);
+    }
+    const float budgetX = barsLeft + barAreaWidth / 2;
+    quads_.append(sf::Vertex(sf::Vector2f(budgetX, margin), budgetColor));
+    quads_.append(sf::Vertex(sf::Vector2f(budgetX + 1, margin), budgetColor));
+    quads_.append(sf::Vertex(sf::Vector2f(budgetX + 1, panelHeight - margin), budgetColor));
+    quads_.append(sf::Vertex(sf::Vector2f(budgetX, panelHeight - margin), budgetColor));
+    target.draw(quads_);
+
+    if (!haveFont_) {
+        return;
+    }
+    char text[96];
+    for (size_t s = 0; s < numStages; ++s) {
+        const auto stage = static_cast<Stage>(s);
+        const auto &histogram = stats[stage];
+        snprintf(text, sizeof(text), "%-16s p50 %7.2f  p99 %7.2f  max %7.2f ms", stageName(stage),
+                 histogram.percentile(0.5) / 1000., histogram.percentile(0.99) / 1000., histogram.max() / 1000.);
+        label_.setString(text);
+        label_.setPosition(margin, margin + s * rowHeight);
+        target.draw(label_);
+    }
+}
+
+} // namespace PulseView
@@ -0,0 +1,77 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "latency_stats.h"
+
+namespace PulseView {
+
+const char *stageName(Stage stage) noexcept {
+    switch (stage) {
+    case Stage::SourceRead:
+        return "source read";
+    case Stage::SourceLatency:
+        return "source latency";
+    case Stage::Capture:
+        return "capture";
+    case Stage::Events:
+        return "events";
+    case Stage::Draw:
+        return "draw";
+    case Stage::Display:
+        return "display";
+    case Stage::Frame:
+        return "frame";
+    case Stage::AudioToPhoton:
+        return "audio to photon";
+    }
+    return "";
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t micros) noexcept {
+    if (micros < subBuckets) {
+        return micros;
+    }
+    const unsigned exponent = 63 - __builtin_clzll(micros);
+    const auto sub = (micros >> (exponent - subBucketBits)) & (subBuckets - 1);
+    return subBuckets + (exponent - subBucketBits) * subBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) noexcept {
+    if (index < subBuckets) {
+        return index;
+    }
+    const auto shift = (index - subBuckets) / subBuckets;
+    const auto sub = (index - subBuckets) % subBuckets;
+    return ((subBuckets + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t micros) noexcept {
+    buckets_[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    auto max = max_.load(std::memory_order_relaxed);
+    while (micros > max && !max_.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double p) const noexcept {
+    const auto total = count();
+    if (total == 0) {
+        return 0;
+    }
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < numBuckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return std::min(bucketUpperBound(i), max());
+        }
+    }
+    return max();
+}
+
+} // namespace PulseView
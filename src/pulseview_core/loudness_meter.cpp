@@ -0,0 +1,231 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "loudness_meter.h"
+
+namespace PulseView {
+
+namespace {
+
+constexpr double negativeInfinity = -std::numeric_limits<double>::infinity();
+
+// Loudness of a channel weighted mean square
+double toLoudness(double energy) noexcept { return energy > 0. ? -0.691 + 10. * std::log10(energy) : negativeInfinity; }
+
+double fromLoudness(double loudness) noexcept { return std::pow(10., (loudness + 0.691) / 10.); }
+
+// The K-weighting filters for any rate, from the analogue prototypes of the 48 kHz coefficients in BS.1770
+void shelfCoefficients(double sampleRate, double *b, double *a) noexcept {
+    constexpr double f0 = 1681.974450955533;
+    constexpr double gain = 3.999843853973347;
+    constexpr double q = 0.7071752369554196;
+    const double k = std::tan(M_PI * f0 / sampleRate);
+    const double vh = std::pow(10., gain / 20.);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    const double a0 = 1. + k / q + k * k;
+    b[0] = (vh + vb * k / q + k * k) / a0;
+    b[1] = 2. * (k * k - vh) / a0;
+    b[2] = (vh - vb * k / q + k * k) / a0;
+    a[0] = 2. * (k * k - 1.) / a0;
+    a[1] = (1. - k / q + k * k) / a0;
+}
+
+void highPassCoefficients(double sampleRate, double *b, double *a) noexcept {
+    constexpr double f0 = 38.13547087602444;
+    constexpr double q = 0.5003270373238773;
+    const double k = std::tan(M_PI * f0 / sampleRate);
+    const double a0 = 1. + k / q + k * k;
+    b[0] = 1.;
+    b[1] = -2.;
+    b[2] = 1.;
+    a[0] = 2. * (k * k - 1.) / a0;
+    a[1] = (1. - k / q + k * k) / a0;
+}
+
+} // namespace
+
+double toDecibels(double amplitude) noexcept {
+    return amplitude > 0. ? 20. * std::log10(amplitude) : negativeInfinity;
+}
+
+LoudnessMeter::LoudnessMeter(size_t numChannels, size_t sampleRate)
+    : stepFrames_{sampleRate / stepsPerSecond}, oversampling_{sampleRate < 96000 ? 4u : sampleRate < 192000 ? 2u : 1u},
+      channels_(numChannels),
+      loudness_{negativeInfinity, negativeInfinity, negativeInfinity} {
+    if (numChannels == 0 || stepFrames_ == 0) {
+        die("A loudness meter needs at least one channel and a sample rate of at least 10 Hz");
+    }
+    // Windowed sinc cutting off at the original Nyquist frequency, split into phases so each output only sums the
+    // taps that land on input samples
+    const size_t numTaps = oversampling_ * tapsPerPhase;
+    std::vector<double> prototype(numTaps);
+    double sum = 0.;
+    for (size_t n = 0; n < numTaps; ++n) {
+        const double t = (n - (numTaps - 1) / 2.) / oversampling_;
+        const double sinc = t == 0. ? 1. : std::sin(M_PI * t) / (M_PI * t);
+        const double phase = 2. * M_PI * n / (numTaps - 1);
+        const double blackman = .42 - .5 * std::cos(phase) + .08 * std::cos(2. * phase);
+        prototype[n] = sinc * blackman;
+        sum += prototype[n];
+    }
+    taps_.resize(numTaps);
+    for (size_t p = 0; p < oversampling_; ++p) {
+        for (size_t t = 0; t < tapsPerPhase; ++t) {
+            taps_[p * tapsPerPhase + t] = prototype[p + oversampling_ * t] * oversampling_ / sum;
+        }
+    }
+    double shelfB[3], shelfA[2], highPassB[3], highPassA[2];
+    shelfCoefficients(sampleRate, shelfB, shelfA);
+    highPassCoefficients(sampleRate, highPassB, highPassA);
+    for (size_t c = 0; c < numChannels; ++c) {
+        auto &channel = channels_[c];
+        channel.shelf = Biquad{shelfB[0], shelfB[1], shelfB[2], shelfA[0], shelfA[1]};
+        channel.highPass = Biquad{highPassB[0], highPassB[1], highPassB[2], highPassA[0], highPassA[1]};
+        channel.weight = numChannels == 6 && c == 3 ? 0. : numChannels == 6 && c >= 4 ? 1.41 : 1.;
+        channel.recent.resize(2 * tapsPerPhase);
+    }
+    for (size_t i = 0; i < numHistogramBins; ++i) {
+        binEnergies_[i] = fromLoudness(histogramFloor + (i + .5) * histogramBinWidth);
+    }
+}
+
+void LoudnessMeter::reset() noexcept {
+    histogram_.fill(0);
+    loudness_.integrated = negativeInfinity;
+    for (auto &channel : channels_) {
+        channel.levels.maxTruePeak = 0.;
+    }
+}
+
+void LoudnessMeter::add(Channel &channel, double x) noexcept {
+    const double weighted = channel.highPass.process(channel.shelf.process(x));
+    channel.stepWeighted += weighted * weighted;
+    channel.stepSquares += x * x;
+    const double magnitude = std::abs(x);
+    channel.stepPeak = std::max(channel.stepPeak, magnitude);
+    double truePeak = magnitude;
+    if (oversampling_ > 1) {
+        channel.recentPos = (channel.recentPos + tapsPerPhase - 1) % tapsPerPhase;
+        channel.recent[channel.recentPos] = channel.recent[channel.recentPos + tapsPerPhase] = x;
+        const double *recent = channel.recent.data() + channel.recentPos;
+        for (size_t p = 0; p < oversampling_; ++p) {
+            const double *phase = taps_.data() + p * tapsPerPhase;
+            double y = 0.;
+            for (size_t t = 0; t < tapsPerPhase; ++t) {
+                y += phase[t] * recent[t];
+            }
+            truePeak = std::max(truePeak, std::abs(y));
+        }
+    }
+    channel.stepTruePeak = std::max(channel.stepTruePeak, truePeak);
+}
+
+// A channel at a time up to the end of each step, so each channel's filter state stays in registers
+template <typename Read> void LoudnessMeter::feed(size_t numFrames, Read read) noexcept {
+    for (size_t done = 0; done < numFrames;) {
+        const auto n = std::min(numFrames - done, stepFrames_ - framesInStep_);
+        for (size_t c = 0; c < channels_.size(); ++c) {
+            auto &channel = channels_[c];
+            for (size_t i = done; i < done + n; ++i) {
+                add(channel, read(c, i));
+            }
+        }
+        done += n;
+        framesInStep_ += n;
+        if (framesInStep_ == stepFrames_) {
+            framesInStep_ = 0;
+            finishStep();
+        }
+    }
+}
+
+template <typename T> void LoudnessMeter::process(const T *const *channels, size_t numFrames) noexcept {
+    feed(numFrames, [channels](size_t c, size_t i) { return static_cast<double>(channels[c][i]); });
+}
+
+void LoudnessMeter::processInterleaved(const S16NESample *interleaved, size_t numFrames) noexcept {
+    constexpr double scale = std::numeric_limits<S16NESample>::max();
+    const auto numChannels = channels_.size();
+    feed(numFrames, [=](size_t c, size_t i) { return interleaved[i * numChannels + c] / scale; });
+}
+
+void LoudnessMeter::finishStep() noexcept {
+    const auto slot = numSteps_ % momentarySteps;
+    double energy = 0.;
+    for (auto &channel : channels_) {
+        energy += channel.weight * channel.stepWeighted / stepFrames_;
+        channel.squares[slot] = channel.stepSquares;
+        channel.peaks[slot] = channel.stepPeak;
+        channel.truePeaks[slot] = channel.stepTruePeak;
+        channel.levels.maxTruePeak = std::max(channel.levels.maxTruePeak, channel.stepTruePeak);
+        channel.stepWeighted = channel.stepSquares = channel.stepPeak = channel.stepTruePeak = 0.;
+    }
+    stepEnergies_[numSteps_ % shortTermSteps] = energy;
+    ++numSteps_;
+
+    const auto held = std::min<uint64_t>(numSteps_, momentarySteps);
+    for (auto &channel : channels_) {
+        double squares = 0.;
+        for (auto s : channel.squares) {
+            squares += s;
+        }
+        channel.levels.rms = std::sqrt(squares / (held * stepFrames_));
+        channel.levels.peak = *std::max_element(channel.peaks.begin(), channel.peaks.end());
+        channel.levels.truePeak = *std::max_element(channel.truePeaks.begin(), channel.truePeaks.end());
+    }
+    if (numSteps_ < momentarySteps) {
+        return;
+    }
+    // Mean of the newest count steps
+    auto meanEnergy = [this](uint64_t count) {
+        double sum = 0.;
+        for (uint64_t s = numSteps_ - count; s < numSteps_; ++s) {
+            sum += stepEnergies_[s % shortTermSteps];
+        }
+        return sum / count;
+    };
+    loudness_.momentary = toLoudness(meanEnergy(momentarySteps));
+    loudness_.shortTerm = toLoudness(meanEnergy(std::min<uint64_t>(numSteps_, shortTermSteps)));
+    // Each step ends a 400 ms gating block overlapping the last by 75%, the momentary loudness. Blocks at or below
+    // the absolute gate never count.
+    if (loudness_.momentary > histogramFloor) {
+        const auto bin = static_cast<size_t>((loudness_.momentary - histogramFloor) / histogramBinWidth);
+        ++histogram_[std::min(bin, numHistogramBins - 1)];
+        loudness_.integrated = integrated();
+    }
+}
+
+double LoudnessMeter::integrated() const noexcept {
+    // The relative gate is 10 LU below the mean of every block through the absolute gate
+    uint64_t count = 0;
+    double sum = 0.;
+    for (size_t i = 0; i < numHistogramBins; ++i) {
+        count += histogram_[i];
+        sum += histogram_[i] * binEnergies_[i];
+    }
+    if (count == 0) {
+        return negativeInfinity;
+    }
+    const auto relativeGate = toLoudness(sum / count) - 10.;
+    const auto first =
+        relativeGate > histogramFloor ? static_cast<size_t>((relativeGate - histogramFloor) / histogramBinWidth) : 0;
+    count = 0;
+    sum = 0.;
+    for (size_t i = std::min(first, numHistogramBins - 1); i < numHistogramBins; ++i) {
+        count += histogram_[i];
+        sum += histogram_[i] * binEnergies_[i];
+    }
+    return count ? toLoudness(sum / count) : negativeInfinity;
+}
+
+template void LoudnessMeter::process(const double *const *channels, size_t numFrames) noexcept;
+template void LoudnessMeter::process(const float *const *channels, size_t numFrames) noexcept;
+
+} // namespace PulseView
@@ -3,8 +3,16 @@
 // Date: 2020-06-06
 //
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
 #include <iostream>
 #include <limits>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -13,64 +21,186 @@
 
 namespace PulseView::AudioSource {
 
-PCMProcessSource::PCMProcessSource() {
+namespace {
+
+// Enough for about 2.7s of 48kHz stereo S16, so a slow reader doesn't stall the producer. Unprivileged processes are
+// limited by /proc/sys/fs/pipe-max-size (1MiB by default).
+constexpr int pipeSize = 1 << 19;
+
+S16NESample toS16(const unsigned char *sample, conversion::SampleFormat format) noexcept {
+    switch (format) {
+    case conversion::SampleFormat::S16NE: {
+        int16_t s;
+        memcpy(&s, sample, sizeof(s));
+        return s;
+    }
+    case conversion::SampleFormat::S32NE: {
+        int32_t s;
+        memcpy(&s, sample, sizeof(s));
+        return static_cast<S16NESample>(s >> 16);
+    }
+    case conversion::SampleFormat::F32NE: {
+        float s;
+        memcpy(&s, sample, sizeof(s));
+        const auto max = std::numeric_limits<S16NESample>::max();
+        return static_cast<S16NESample>(std::lrint(std::clamp(s, -1.f, 1.f) * max));
+    }
+    }
+    return 0;
+}
+
+} // namespace
+
+PCMStreamConfig PCMProcessSource::pacat(size_t sampleRate) {
+    PCMStreamConfig config;
+    config.command = "pacat --raw --record --latency-msec=10 --format=s16ne --channels=2 --rate=" +
+                     std::to_string(sampleRate);
+    config.sampleRate = sampleRate;
+    return config;
+}
+
+PCMProcessSource::PCMProcessSource(PCMStreamConfig config) : config_{std::move(config)} {
+    if (config_.numChannels < 1) {
+        die("PCM source needs at least one channel");
+    }
+    if (config_.command.empty()) {
+        processFD_ = config_.fd;
+    } else {
+        spawn();
+    }
+    try {
+        setUpFD();
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+void PCMProcessSource::spawn() {
     int fildes[2];
-    if (pipe(fildes) < 0) {
+    if (pipe2(fildes, O_CLOEXEC) < 0) {
         PulseView::fail_errno("Failed to call pipe(): ");
     }
     pid_t pid = fork();
     if (pid < 0) {
+        close(fildes[0]);
+        close(fildes[1]);
         PulseView::fail_errno("Failed to call fork(): ");
     } else if (pid == 0) {
-        // we are the child
+        // we are the child, only async-signal-safe calls from here on
         dup2(fildes[1], STDOUT_FILENO);
-        std::vector<const char *> procArgv;
-        procArgv.push_back(static_cast<const char *>("pacat"));
-        procArgv.push_back(static_cast<const char *>("--raw"));
-        procArgv.push_back(static_cast<const char *>("--record"));
-        procArgv.push_back(static_cast<const char *>("--latency-msec=10"));
-        procArgv.push_back(static_cast<const char *>("--format=s16ne"));
-        procArgv.push_back(static_cast<const char *>("--rate=61440"));
-        procArgv.push_back(nullptr);
-        auto argv = const_cast<char **>(&procArgv[0]);
-        if (execvp(procArgv[0], argv) < 0) {
-            PulseView::fail_errno("Failed to exec() source process: ");
+        execl("/bin/sh", "sh", "-c", config_.command.c_str(), static_cast<char *>(nullptr));
+        _exit(127);
+    }
+    // we are the parent, closing the write end lets reads see EOF once the child exits
+    close(fildes[1]);
+    processFD_ = fildes[0];
+    processPID_ = pid;
+}
+
+void PCMProcessSource::setUpFD() {
+    // Fails for anything that isn't a pipe, which is fine
+    fcntl(processFD_, F_SETPIPE_SZ, pipeSize);
+
+    epollFD_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFD_ < 0) {
+        PulseView::fail_errno("Failed to call epoll_create1(): ");
+    }
+    wakeFD_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFD_ < 0) {
+        PulseView::fail_errno("Failed to call eventfd(): ");
+    }
+    epoll_event wake{};
+    wake.events = EPOLLIN;
+    wake.data.fd = wakeFD_;
+    if (epoll_ctl(epollFD_, EPOLL_CTL_ADD, wakeFD_, &wake) < 0) {
+        PulseView::fail_errno("Failed to call epoll_ctl(): ");
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = processFD_;
+    if (epoll_ctl(epollFD_, EPOLL_CTL_ADD, processFD_, &ev) < 0) {
+        if (errno != EPERM) {
+            PulseView::fail_errno("Failed to call epoll_ctl(): ");
         }
-    } else {
-        // we are the parent
-        processFD_ = fildes[0];
-        processPID_ = pid;
+        pollable_ = false;
+        return;
+    }
+    const int flags = fcntl(processFD_, F_GETFL);
+    if (flags < 0 || fcntl(processFD_, F_SETFL, flags | O_NONBLOCK) < 0) {
+        PulseView::fail_errno("Failed to make PCM source non-blocking: ");
     }
 }
 
-PCMProcessSource::~PCMProcessSource() noexcept {
-    kill(processPID_, SIGTERM);
-    waitpid(processPID_, nullptr, 0);
+PCMProcessSource::~PCMProcessSource() noexcept { release(); }
+
+void PCMProcessSource::release() noexcept {
+    if (epollFD_ >= 0) {
+        close(epollFD_);
+        epollFD_ = -1;
+    }
+    if (wakeFD_ >= 0) {
+        close(wakeFD_);
+        wakeFD_ = -1;
+    }
+    if (processPID_ > 0) {
+        close(processFD_);
+        kill(processPID_, SIGTERM);
+        waitpid(processPID_, nullptr, 0);
+        processPID_ = -1;
+    }
+    processFD_ = -1;
 }
 
 void PCMProcessSource::populateFrame(PulseView::Frame &frame) {
-    frame.clear();
-    const size_t bytesToRead = numChannels_ * sizeof(PulseView::S16NESample) * frame.numSamples;
-    std::vector<char> buffer(bytesToRead);
+    buffer_.resize(config_.numChannels * frame.numSamples);
+    read(buffer_.data(), frame.numSamples);
+    frame.loadInterleaved(buffer_.data(), config_.numChannels);
+    frame.finalize();
+}
+
+void PCMProcessSource::readBytes(void *out, size_t numBytes) {
+    auto *bytes = static_cast<char *>(out);
     size_t bytesRead{0};
-    while (bytesRead < bytesToRead) {
-        ssize_t readResult = read(processFD_, buffer.data() + bytesRead, bytesToRead - bytesRead);
-        if (readResult < 0) {
-            PulseView::fail_errno("Failed to read() from child process: ");
-        } else {
+    while (bytesRead < numBytes && !interrupted_.load(std::memory_order_acquire)) {
+        ssize_t readResult = ::read(processFD_, bytes + bytesRead, numBytes - bytesRead);
+        if (readResult > 0) {
             bytesRead += readResult;
+        } else if (readResult == 0) {
+            die("PCM source reached the end of its stream");
+        } else if (errno == EAGAIN && pollable_) {
+            epoll_event ev;
+            if (epoll_wait(epollFD_, &ev, 1, -1) < 0 && errno != EINTR) {
+                PulseView::fail_errno("Failed to call epoll_wait(): ");
+            }
+        } else if (errno != EINTR) {
+            PulseView::fail_errno("Failed to read() from PCM source: ");
         }
     }
-    const auto *samples = reinterpret_cast<PulseView::S16NESample *>(buffer.data());
-    const double maxSize = std::numeric_limits<PulseView::S16NESample>::max();
-    for (size_t i = 0; i < frame.numSamples; ++i) {
-        const auto *offset = samples + numChannels_ * i;
-        const auto leftSample = ((double)offset[0]) / maxSize;
-        const auto rightSample = ((double)offset[1]) / maxSize;
-        frame.getChunk(PulseView::AudioChannel::Left).samples.push_back(leftSample);
-        frame.getChunk(PulseView::AudioChannel::Right).samples.push_back(rightSample);
+}
+
+void PCMProcessSource::interrupt() noexcept {
+    interrupted_.store(true, std::memory_order_release);
+    if (wakeFD_ >= 0) {
+        // Never read back, so it stays readable. Writing only fails once the counter would overflow, when it's
+        // readable anyway.
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(wakeFD_, &one, sizeof(one));
+    }
+}
+
+void PCMProcessSource::read(PulseView::S16NESample *buffer, size_t numFrames) {
+    const auto sampleBytes = conversion::bytesPerSample(config_.format);
+    const auto numSamples = numFrames * config_.numChannels;
+    if (config_.format == conversion::SampleFormat::S16NE) {
+        readBytes(buffer, numSamples * sampleBytes);
+        return;
+    }
+    raw_.resize(numSamples * sampleBytes);
+    readBytes(raw_.data(), raw_.size());
+    for (size_t i = 0; i < numSamples; ++i) {
+        buffer[i] = toS16(raw_.data() + i * sampleBytes, config_.format);
     }
-    frame.finalize();
 }
 
 } // namespace PulseView::AudioSource
@@ -19,27 +19,38 @@ namespace PulseView::AudioSource {
 
 void fail_pulse(std::string err, int pulseErrorCode) { throw std::runtime_error(err + pa_strerror(pulseErrorCode)); }
 
-PulseAudioSource::PulseAudioSource(size_t audioRate) : simple_(nullptr) {
+PulseAudioSource::PulseAudioSource(size_t audioRate, size_t fragmentFrames, const std::string &device,
+                                   size_t numChannels)
+    : simple_(nullptr), numChannels_(numChannels) {
     pa_sample_spec ss;
     ss.format = PA_SAMPLE_S16NE;
     ss.channels = numChannels_;
     ss.rate = audioRate;
     int error = 0;
 
-    simple_ =
-        pa_simple_new(nullptr, "PulseView", PA_STREAM_RECORD, nullptr, "Oscilloscope", &ss, nullptr, nullptr, &error);
+    pa_buffer_attr attr;
+    attr.maxlength = static_cast<uint32_t>(-1);
+    attr.tlength = static_cast<uint32_t>(-1);
+    attr.prebuf = static_cast<uint32_t>(-1);
+    attr.minreq = static_cast<uint32_t>(-1);
+    attr.fragsize = fragmentFrames ? fragmentFrames * numChannels_ * sizeof(PulseView::S16NESample)
+                                   : static_cast<uint32_t>(-1);
+
+    simple_ = pa_simple_new(nullptr, "PulseView", PA_STREAM_RECORD, device.empty() ? nullptr : device.c_str(),
+                            "Oscilloscope", &ss, nullptr, &attr, &error);
     if (simple_ == nullptr) {
         fail_pulse("Failed to connect to pulseaudio: ", error);
     }
 }
 
-PulseAudioSource::PulseAudioSource(PulseAudioSource &&other) {
+PulseAudioSource::PulseAudioSource(PulseAudioSource &&other) : numChannels_(other.numChannels_) {
     simple_ = other.simple_;
     other.simple_ = nullptr;
 }
 
 PulseAudioSource &PulseAudioSource::operator=(PulseAudioSource &&other) {
     simple_ = other.simple_;
+    numChannels_ = other.numChannels_;
     other.simple_ = nullptr;
     return *this;
 }
@@ -52,26 +63,27 @@ PulseAudioSource::~PulseAudioSource() noexcept {
 }
 
 void PulseAudioSource::populateFrame(PulseView::Frame &frame) {
-    frame.clear();
-    const size_t bytesToRead = numChannels_ * sizeof(PulseView::S16NESample) * frame.numSamples;
-    std::vector<char> buffer(bytesToRead);
+    buffer_.resize(numChannels_ * frame.numSamples);
+    read(buffer_.data(), frame.numSamples);
+    frame.loadInterleaved(buffer_.data(), numChannels_);
+    frame.finalize();
+}
+
+void PulseAudioSource::read(PulseView::S16NESample *buffer, size_t numFrames) {
+    const size_t bytesToRead = numChannels_ * sizeof(PulseView::S16NESample) * numFrames;
     int error = 0;
     // TODO: Move to async API, avoids lag on first read
     // std::cout << "PA: Starting read\n";
-    if (pa_simple_read(simple_, buffer.data(), bytesToRead, &error) < 0) {
+    if (pa_simple_read(simple_, buffer, bytesToRead, &error) < 0) {
         fail_pulse("Failed to read from pulseaudio source", error);
     }
     // std::cout << "PA: Finished read\n";
-    const auto *samples = reinterpret_cast<PulseView::S16NESample *>(buffer.data());
-    const double maxSize = std::numeric_limits<PulseView::S16NESample>::max();
-    for (size_t i = 0; i < frame.numSamples; ++i) {
-        const auto *offset = samples + numChannels_ * i;
-        const auto leftSample = ((double)offset[0]) / maxSize;
-        const auto rightSample = ((double)offset[1]) / maxSize;
-        frame.getChunk(PulseView::AudioChannel::Left).samples.push_back(leftSample);
-        frame.getChunk(PulseView::AudioChannel::Right).samples.push_back(rightSample);
-    }
-    frame.finalize();
+}
+
+uint64_t PulseAudioSource::latencyMicros() {
+    int error = 0;
+    const pa_usec_t latency = pa_simple_get_latency(simple_, &error);
+    return latency == static_cast<pa_usec_t>(-1) ? 0 : latency;
 }
 
 } // namespace PulseView::AudioSource
@@ -0,0 +1,195 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <pulse/pulseaudio.h>
+
+#include "pulseaudio_stream_source.h"
+
+namespace PulseView::AudioSource {
+
+namespace {
+
+constexpr uint32_t serverDefault = static_cast<uint32_t>(-1);
+
+// Holds the mainloop lock for a scope, callbacks can't run while it's held
+class MainloopLock {
+  public:
+    explicit MainloopLock(pa_threaded_mainloop *mainloop) : mainloop_{mainloop} { pa_threaded_mainloop_lock(mainloop); }
+    ~MainloopLock() { pa_threaded_mainloop_unlock(mainloop_); }
+    MainloopLock(const MainloopLock &) = delete;
+    MainloopLock &operator=(const MainloopLock &) = delete;
+
+  private:
+    pa_threaded_mainloop *mainloop_;
+};
+
+} // namespace
+
+PulseAudioStreamSource::PulseAudioStreamSource(size_t audioRate, size_t fragmentFrames, const std::string &device,
+                                               size_t numChannels)
+    : numChannels_{numChannels} {
+    mainloop_ = pa_threaded_mainloop_new();
+    if (!mainloop_) {
+        die("Failed to create pulseaudio mainloop");
+    }
+    context_ = pa_context_new(pa_threaded_mainloop_get_api(mainloop_), "PulseView");
+    if (!context_) {
+        close();
+        die("Failed to create pulseaudio context");
+    }
+    pa_context_set_state_callback(context_, &PulseAudioStreamSource::onContextState, this);
+    if (pa_threaded_mainloop_start(mainloop_) < 0) {
+        close();
+        die("Failed to start pulseaudio mainloop");
+    }
+    try {
+        MainloopLock lock{mainloop_};
+        if (pa_context_connect(context_, nullptr, PA_CONTEXT_NOFLAGS, nullptr) < 0) {
+            failLocked("Failed to connect to pulseaudio: ");
+        }
+        while (pa_context_get_state(context_) != PA_CONTEXT_READY) {
+            if (pa_context_get_state(context_) == PA_CONTEXT_FAILED ||
+                pa_context_get_state(context_) == PA_CONTEXT_TERMINATED) {
+                failLocked("Failed to connect to pulseaudio: ");
+            }
+            pa_threaded_mainloop_wait(mainloop_);
+        }
+
+        pa_sample_spec ss;
+        ss.format = PA_SAMPLE_S16NE;
+        ss.channels = numChannels_;
+        ss.rate = audioRate;
+        stream_ = pa_stream_new(context_, "Oscilloscope", &ss, nullptr);
+        if (!stream_) {
+            failLocked("Failed to create pulseaudio stream: ");
+        }
+        pa_stream_set_state_callback(stream_, &PulseAudioStreamSource::onStreamState, this);
+        pa_stream_set_read_callback(stream_, &PulseAudioStreamSource::onReadable, this);
+
+        pa_buffer_attr attr;
+        attr.maxlength = serverDefault;
+        attr.tlength = serverDefault;
+        attr.prebuf = serverDefault;
+        attr.minreq = serverDefault;
+        attr.fragsize = fragmentFrames ? fragmentFrames * numChannels_ * sizeof(S16NESample) : serverDefault;
+        const auto flags = static_cast<pa_stream_flags_t>(PA_STREAM_ADJUST_LATENCY | PA_STREAM_AUTO_TIMING_UPDATE |
+                                                          PA_STREAM_INTERPOLATE_TIMING);
+        if (pa_stream_connect_record(stream_, device.empty() ? nullptr : device.c_str(), &attr, flags) < 0) {
+            failLocked("Failed to record from pulseaudio: ");
+        }
+        while (pa_stream_get_state(stream_) != PA_STREAM_READY) {
+            if (pa_stream_get_state(stream_) == PA_STREAM_FAILED ||
+                pa_stream_get_state(stream_) == PA_STREAM_TERMINATED) {
+                failLocked("Failed to record from pulseaudio: ");
+            }
+            pa_threaded_mainloop_wait(mainloop_);
+        }
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+PulseAudioStreamSource::~PulseAudioStreamSource() noexcept { close(); }
+
+void PulseAudioStreamSource::close() noexcept {
+    if (mainloop_) {
+        pa_threaded_mainloop_stop(mainloop_);
+    }
+    if (stream_) {
+        pa_stream_disconnect(stream_);
+        pa_stream_unref(stream_);
+        stream_ = nullptr;
+    }
+    if (context_) {
+        pa_context_disconnect(context_);
+        pa_context_unref(context_);
+        context_ = nullptr;
+    }
+    if (mainloop_) {
+        pa_threaded_mainloop_free(mainloop_);
+        mainloop_ = nullptr;
+    }
+}
+
+void PulseAudioStreamSource::failLocked(const std::string &err) {
+    throw std::runtime_error(err + pa_strerror(pa_context_errno(context_)));
+}
+
+void PulseAudioStreamSource::onContextState(pa_context *, void *self) {
+    pa_threaded_mainloop_signal(static_cast<PulseAudioStreamSource *>(self)->mainloop_, 0);
+}
+
+void PulseAudioStreamSource::onStreamState(pa_stream *, void *self) {
+    pa_threaded_mainloop_signal(static_cast<PulseAudioStreamSource *>(self)->mainloop_, 0);
+}
+
+void PulseAudioStreamSource::onReadable(pa_stream *, size_t, void *self) {
+    pa_threaded_mainloop_signal(static_cast<PulseAudioStreamSource *>(self)->mainloop_, 0);
+}
+
+void PulseAudioStreamSource::populateFrame(PulseView::Frame &frame) {
+    buffer_.resize(numChannels_ * frame.numSamples);
+    read(buffer_.data(), frame.numSamples);
+    frame.loadInterleaved(buffer_.data(), numChannels_);
+    frame.finalize();
+}
+
+void PulseAudioStreamSource::read(PulseView::S16NESample *buffer, size_t numFrames) {
+    auto *out = reinterpret_cast<char *>(buffer);
+    const size_t bytesToRead = numChannels_ * sizeof(PulseView::S16NESample) * numFrames;
+    size_t bytesRead{0};
+    MainloopLock lock{mainloop_};
+    while (bytesRead < bytesToRead && !interrupted_) {
+        if (pa_stream_get_state(stream_) != PA_STREAM_READY) {
+            failLocked("Pulseaudio stream stopped: ");
+        }
+        const void *data;
+        size_t length;
+        if (pa_stream_peek(stream_, &data, &length) < 0) {
+            failLocked("Failed to read from pulseaudio: ");
+        }
+        if (length == 0) {
+            // Woken by onReadable
+            pa_threaded_mainloop_wait(mainloop_);
+            continue;
+        }
+        const auto n = std::min(length - peekOffset_, bytesToRead - bytesRead);
+        if (data) {
+            memcpy(out + bytesRead, static_cast<const char *>(data) + peekOffset_, n);
+        } else {
+            // A hole where the server had no audio
+            memset(out + bytesRead, 0, n);
+        }
+        bytesRead += n;
+        peekOffset_ += n;
+        if (peekOffset_ == length) {
+            pa_stream_drop(stream_);
+            peekOffset_ = 0;
+        }
+    }
+}
+
+void PulseAudioStreamSource::interrupt() noexcept {
+    MainloopLock lock{mainloop_};
+    interrupted_ = true;
+    pa_threaded_mainloop_signal(mainloop_, 0);
+}
+
+uint64_t PulseAudioStreamSource::latencyMicros() {
+    MainloopLock lock{mainloop_};
+    pa_usec_t latency = 0;
+    int negative = 0;
+    if (pa_stream_get_latency(stream_, &latency, &negative) < 0 || negative) {
+        return 0;
+    }
+    return latency;
+}
+
+} // namespace PulseView::AudioSource
@@ -0,0 +1,272 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "recorder.h"
+
+namespace PulseView {
+
+namespace {
+
+// O_DIRECT needs buffers, offsets and lengths aligned to the logical block size, which this covers
+constexpr size_t blockAlignment = 4096;
+// Bytes per write, a whole number of blocks
+constexpr size_t writeBytes = 1 << 20;
+// How much audio the queue holds before blocks are dropped
+constexpr size_t queueSeconds = 4;
+// How long the writer sleeps when the queue is empty
+constexpr std::chrono::milliseconds pollInterval{20};
+
+// The header takes a whole block, padded with a JUNK chunk, so the samples that follow stay block aligned
+constexpr size_t wavHeaderBytes = blockAlignment;
+
+void writeLE16(unsigned char *p, uint16_t v) noexcept {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+void writeLE32(unsigned char *p, uint32_t v) noexcept {
+    writeLE16(p, v);
+    writeLE16(p + 2, v >> 16);
+}
+
+// Sizes past 4GiB saturate, as in a streamed WAV, which readers take the length of from the file instead
+void writeWavHeader(unsigned char *header, size_t numChannels, size_t sampleRate, uint64_t dataBytes) noexcept {
+    constexpr uint64_t maxChunkSize = std::numeric_limits<uint32_t>::max();
+    const auto bytesPerFrame = numChannels * sizeof(S16NESample);
+    std::memset(header, 0, wavHeaderBytes);
+    std::memcpy(header, "RIFF", 4);
+    writeLE32(header + 4, std::min(dataBytes + wavHeaderBytes - 8, maxChunkSize));
+    std::memcpy(header + 8, "WAVE", 4);
+    std::memcpy(header + 12, "fmt ", 4);
+    writeLE32(header + 16, 16);
+    writeLE16(header + 20, 1);
+    writeLE16(header + 22, numChannels);
+    writeLE32(header + 24, sampleRate);
+    writeLE32(header + 28, sampleRate * bytesPerFrame);
+    writeLE16(header + 32, bytesPerFrame);
+    writeLE16(header + 34, 16);
+    std::memcpy(header + 36, "JUNK", 4);
+    writeLE32(header + 40, wavHeaderBytes - 52);
+    std::memcpy(header + wavHeaderBytes - 8, "data", 4);
+    writeLE32(header + wavHeaderBytes - 4, std::min(dataBytes, maxChunkSize));
+}
+
+} // namespace
+
+// Buffers samples into block aligned writes of writeBytes, finishing with a padded write trimmed back by ftruncate
+class Recorder::AudioFileWriter {
+  public:
+    AudioFileWriter(const std::string &path, RecordFormat format, size_t numChannels, size_t sampleRate)
+        : path_{path}, format_{format}, numChannels_{numChannels}, sampleRate_{sampleRate},
+          buffer_{static_cast<unsigned char *>(std::aligned_alloc(blockAlignment, writeBytes)), std::free} {
+        if (!buffer_) {
+            throw std::bad_alloc();
+        }
+        fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+        if (fd_ < 0 && errno == EINVAL) {
+            // e.g. tmpfs, which has no O_DIRECT
+            direct_ = false;
+            fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        }
+        if (fd_ < 0) {
+            PulseView::fail_errno("Failed to open " + path + ": ");
+        }
+        if (format_ == RecordFormat::WAV) {
+            // Rewritten with the real sizes by finish()
+            writeWavHeader(buffer_.get(), numChannels_, sampleRate_, 0);
+            fill_ = wavHeaderBytes;
+        }
+    }
+    AudioFileWriter(const AudioFileWriter &) = delete;
+    AudioFileWriter &operator=(const AudioFileWriter &) = delete;
+    ~AudioFileWriter() noexcept { close(fd_); }
+
+    void append(const S16NESample *samples, size_t numSamples) {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(samples);
+        auto remaining = numSamples * sizeof(S16NESample);
+        while (remaining > 0) {
+            const auto n = std::min(remaining, writeBytes - fill_);
+            std::memcpy(buffer_.get() + fill_, bytes, n);
+            fill_ += n;
+            bytes += n;
+            remaining -= n;
+            if (fill_ == writeBytes) {
+                writeAll(buffer_.get(), writeBytes, offset_);
+                offset_ += writeBytes;
+                fill_ = 0;
+            }
+        }
+    }
+
+    void finish() {
+        const auto length = offset_ + fill_;
+        const auto padded = (fill_ + blockAlignment - 1) / blockAlignment * blockAlignment;
+        std::memset(buffer_.get() + fill_, 0, padded - fill_);
+        writeAll(buffer_.get(), padded, offset_);
+        if (ftruncate(fd_, length) < 0) {
+            PulseView::fail_errno("Failed to truncate " + path_ + ": ");
+        }
+        if (format_ == RecordFormat::WAV) {
+            writeWavHeader(buffer_.get(), numChannels_, sampleRate_, length - wavHeaderBytes);
+            writeAll(buffer_.get(), wavHeaderBytes, 0);
+        }
+    }
+
+  private:
+    void writeAll(const unsigned char *data, size_t size, uint64_t offset) {
+        while (size > 0) {
+            const auto n = pwrite(fd_, data, size, offset);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && errno == EINVAL && direct_) {
+                // Some filesystems accept O_DIRECT on open and only refuse the write
+                direct_ = false;
+                fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) & ~O_DIRECT);
+                continue;
+            }
+            if (n < 0) {
+                PulseView::fail_errno("Failed to write " + path_ + ": ");
+            }
+            data += n;
+            size -= n;
+            offset += n;
+        }
+    }
+
+    std::string path_;
+    RecordFormat format_;
+    size_t numChannels_;
+    size_t sampleRate_;
+    std::unique_ptr<unsigned char, void (*)(void *)> buffer_;
+    int fd_{-1};
+    bool direct_{true};
+    size_t fill_{0};
+    uint64_t offset_{0};
+};
+
+Recorder::Recorder(size_t numChannels, size_t sampleRate, RecordFormat format, const std::string &path,
+                   size_t preTriggerFrames)
+    : numChannels_{numChannels}, sampleRate_{sampleRate}, format_{format},
+      queue_{queueSeconds * sampleRate * numChannels}, preTrigger_(preTriggerFrames * numChannels) {
+    if (numChannels_ == 0) {
+        die("Can't record zero channels");
+    }
+    if (!path.empty()) {
+        recording_ = std::make_unique<AudioFileWriter>(path, format_, numChannels_, sampleRate_);
+    }
+    thread_ = std::thread{&Recorder::run, this};
+}
+
+Recorder::~Recorder() noexcept {
+    running_.store(false, std::memory_order_release);
+    thread_.join();
+}
+
+void Recorder::push(const S16NESample *interleaved, size_t numFrames) noexcept {
+    const auto numSamples = numFrames * numChannels_;
+    // Whole blocks or nothing, so the queue always holds whole frames
+    if (queue_.writeAvailable() < numSamples) {
+        droppedBlocks_.fetch_add(1, std::memory_order_relaxed);
+        droppedFrames_.fetch_add(numFrames, std::memory_order_relaxed);
+        return;
+    }
+    queue_.push(interleaved, numSamples);
+}
+
+void Recorder::saveSnapshot(const std::string &path) {
+    std::lock_guard<std::mutex> lock{snapshotMutex_};
+    snapshotRequests_.push_back(path);
+}
+
+RecorderMetrics Recorder::metrics() const noexcept {
+    return RecorderMetrics{framesWritten_.load(std::memory_order_relaxed),
+                           droppedBlocks_.load(std::memory_order_relaxed),
+                           droppedFrames_.load(std::memory_order_relaxed),
+                           snapshotsSaved_.load(std::memory_order_relaxed), failed_.load(std::memory_order_relaxed)};
+}
+
+void Recorder::run() noexcept {
+    std::vector<S16NESample> block(writeBytes / sizeof(S16NESample) / numChannels_ * numChannels_);
+    while (true) {
+        // Checked before draining, so everything pushed before the destructor ran is written
+        const bool stopping = !running_.load(std::memory_order_acquire);
+        while (const auto n = queue_.pop(block.data(), block.size())) {
+            consume(block.data(), n);
+        }
+        saveSnapshots();
+        if (stopping) {
+            break;
+        }
+        std::this_thread::sleep_for(pollInterval);
+    }
+    if (recording_ && !failed_.load(std::memory_order_relaxed)) {
+        try {
+            recording_->finish();
+        } catch (const std::exception &e) {
+            std::cerr << "Recording failed: " << e.what() << '\n';
+            failed_.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Recorder::consume(const S16NESample *interleaved, size_t numSamples) {
+    if (recording_ && !failed_.load(std::memory_order_relaxed)) {
+        try {
+            recording_->append(interleaved, numSamples);
+            framesWritten_.fetch_add(numSamples / numChannels_, std::memory_order_relaxed);
+        } catch (const std::exception &e) {
+            std::cerr << "Recording failed: " << e.what() << '\n';
+            failed_.store(true, std::memory_order_relaxed);
+        }
+    }
+    if (preTrigger_.empty()) {
+        return;
+    }
+    // Only the newest ring's worth of this block survives
+    if (numSamples > preTrigger_.size()) {
+        interleaved += numSamples - preTrigger_.size();
+        numSamples = preTrigger_.size();
+    }
+    const auto first = std::min(numSamples, preTrigger_.size() - preTriggerNext_);
+    std::copy(interleaved, interleaved + first, preTrigger_.begin() + preTriggerNext_);
+    std::copy(interleaved + first, interleaved + numSamples, preTrigger_.begin());
+    preTriggerFull_ = preTriggerFull_ || preTriggerNext_ + numSamples >= preTrigger_.size();
+    preTriggerNext_ = (preTriggerNext_ + numSamples) % preTrigger_.size();
+}
+
+void Recorder::saveSnapshots() {
+    std::vector<std::string> requests;
+    {
+        std::lock_guard<std::mutex> lock{snapshotMutex_};
+        requests.swap(snapshotRequests_);
+    }
+    for (const auto &path : requests) {
+        try {
+            AudioFileWriter snapshot{path, format_, numChannels_, sampleRate_};
+            if (preTriggerFull_) {
+                snapshot.append(preTrigger_.data() + preTriggerNext_, preTrigger_.size() - preTriggerNext_);
+            }
+            snapshot.append(preTrigger_.data(), preTriggerNext_);
+            snapshot.finish();
+            snapshotsSaved_.fetch_add(1, std::memory_order_relaxed);
+        } catch (const std::exception &e) {
+            std::cerr << "Failed to save snapshot: " << e.what() << '\n';
+        }
+    }
+}
+
+} // namespace PulseView
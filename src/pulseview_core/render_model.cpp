@@ -3,55 +3,62 @@
 // Date: 2020-05-16
 //
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 
 #include <fftw3.h>
 
 #include <fftw_helper.h>
+#include <frame_kernels.h>
 #include <pulseview.h>
 #include <render_model.h>
+#include <sample_conversion.h>
 
 namespace PulseView {
 
-AudioChannel AudioChannels[2] = {AudioChannel::Left, AudioChannel::Right};
-
-void PCMChunk::reserveSize(size_t log2NumSamples) {
+template <typename T>
+void BasicPCMChunk<T>::bind(T *sampleStorage, T *dftStorage, size_t log2NumSamples,
+                            const kernels::FrameKernels<T> *frameKernels) {
     log2Size = log2NumSamples;
+    kernels = frameKernels;
     const size_t size = 1 << log2Size;
-    samples.reserve(size);
-    dft.resize(size);
+    samples = Span<T>{sampleStorage, size};
+    dft = Span<T>{dftStorage, size / 2 + 1};
 }
 
-void PCMChunk::clear() { samples.resize(0); }
+namespace {
+
+// Frames converted before the meter reads them back, a few KiB per channel so they're still in L1
+constexpr size_t meterBlockFrames = 256;
+
+} // namespace
 
-double PCMChunk::minInRange(size_t s, size_t e, size_t numSteps) const {
+template <typename T> void BasicPCMChunk<T>::clear() { std::fill(samples.begin(), samples.end(), T(0)); }
+
+// Both ranges include the sample at e, so adjacent ranges share their boundary sample
+template <typename T> T BasicPCMChunk<T>::minInRange(size_t s, size_t e, size_t numSteps) const {
     assert(s <= e);
     assert(e <= numSteps);
     auto i1 = (s * samples.size()) / numSteps;
-    auto i2 = (e * samples.size()) / numSteps;
-    double rv = 1.;
-    for (auto i = i1; i <= i2; ++i) {
-        rv = std::min(rv, samples[i]);
-    }
-    return rv;
+    auto i2 = std::min((e * samples.size()) / numSteps, samples.size() - 1);
+    return kernels::minMax(samples.data() + i1, i2 - i1 + 1).min;
 }
 
-double PCMChunk::maxInRange(size_t s, size_t e, size_t numSteps) const {
+template <typename T> T BasicPCMChunk<T>::maxInRange(size_t s, size_t e, size_t numSteps) const {
     assert(s <= e);
     assert(e <= numSteps);
     auto i1 = (s * samples.size()) / numSteps;
-    auto i2 = (e * samples.size()) / numSteps;
-    double rv = -1.;
-    for (auto i = i1; i <= i2; ++i) {
-        rv = std::max(rv, samples[i]);
-    }
-    return rv;
+    auto i2 = std::min((e * samples.size()) / numSteps, samples.size() - 1);
+    return kernels::minMax(samples.data() + i1, i2 - i1 + 1).max;
 }
 
-void PCMChunk::calculateDFT(fftw::FFTWHelper &helper) { helper.calculateDFT(samples, dft); }
+template <typename T> void BasicPCMChunk<T>::minMaxEnvelope(size_t numColumns, T *mins, T *maxs) const {
+    kernels->envelope(samples.data(), samples.size(), numColumns, mins, maxs);
+}
 
-double PCMChunk::getDftValueOverRange(size_t s, size_t e, size_t numSteps) const {
+template <typename T> double BasicPCMChunk<T>::getDftValueOverRange(size_t s, size_t e, size_t numSteps) const {
     assert(s <= e);
     assert(e <= numSteps);
     size_t i1 = (s * s * samples.size()) / (2 * numSteps * numSteps);
@@ -65,109 +72,445 @@ double PCMChunk::getDftValueOverRange(size_t s, size_t e, size_t numSteps) const
     return std::pow(rv, 0.7) / 32.;
 }
 
-Frame::Frame(size_t logNumSamples)
-    : log2Size(logNumSamples), numSamples(((size_t)1) << logNumSamples), fftw(logNumSamples) {
-    leftChunk.reserveSize(log2Size);
-    rightChunk.reserveSize(log2Size);
+template <typename T>
+BasicFrame<T>::BasicFrame(size_t logNumSamples, size_t numChannels, fftw::PlannerEffort plannerEffort)
+    : numChannels(numChannels), log2Size(logNumSamples), numSamples(((size_t)1) << logNumSamples),
+      fftw(logNumSamples, numChannels, fftw::SpectrumMode::Magnitude, plannerEffort),
+      dftStride(fftw::cacheLineStride<T>(fftw.numBins)), spectra(numChannels * dftStride), chunks(numChannels),
+      convertOut_(numChannels) {
+    for (size_t c = 0; c < numChannels; ++c) {
+        chunks[c].bind(fftw.input(c), spectra.data() + c * dftStride, log2Size, fftw.kernels);
+    }
 }
 
-void Frame::clear() {
-    leftChunk.clear();
-    rightChunk.clear();
+template <typename T> void BasicFrame<T>::clear() {
+    for (auto &chunk : chunks) {
+        chunk.clear();
+    }
 }
 
-void Frame::finalize() {
-    leftChunk.calculateDFT(fftw);
-    rightChunk.calculateDFT(fftw);
+template <typename T> void BasicFrame<T>::loadInterleaved(const S16NESample *interleaved, size_t srcChannels) {
+    assert(srcChannels == numChannels);
+    for (size_t c = 0; c < numChannels; ++c) {
+        convertOut_[c] = chunks[c].samples.data();
+    }
+    fftw.kernels->load(interleaved, numSamples, numChannels, convertOut_.data());
 }
 
-PCMChunk &Frame::getChunk(AudioChannel channel) noexcept {
-    switch (channel) {
-    case AudioChannel::Left:
-        return leftChunk;
-    case AudioChannel::Right:
-    default:
-        return rightChunk;
+template <typename T>
+void BasicFrame<T>::advance(const S16NESample *interleaved, size_t numFrames, size_t srcChannels,
+                            LoudnessMeter *meter) {
+    if (numFrames >= numSamples) {
+        const auto skipped = numFrames - numSamples;
+        if (!meter) {
+            loadInterleaved(interleaved + skipped * srcChannels, srcChannels);
+            return;
+        }
+        meter->processInterleaved(interleaved, skipped);
+        convertInterleaved(interleaved + skipped * srcChannels, numSamples, srcChannels, 0, meter);
+        return;
+    }
+    const auto kept = numSamples - numFrames;
+    for (auto &chunk : chunks) {
+        auto *samples = chunk.samples.data();
+        std::copy(samples + numFrames, samples + numSamples, samples);
     }
+    convertInterleaved(interleaved, numFrames, srcChannels, kept, meter);
 }
 
-const PCMChunk &Frame::getChunk(AudioChannel channel) const noexcept {
-    switch (channel) {
-    case AudioChannel::Left:
-        return leftChunk;
-    case AudioChannel::Right:
-    default:
-        return rightChunk;
+template <typename T>
+void BasicFrame<T>::convertInterleaved(const S16NESample *interleaved, size_t numFrames, size_t srcChannels,
+                                       size_t offset, LoudnessMeter *meter) {
+    assert(srcChannels == numChannels);
+    assert(offset + numFrames <= numSamples);
+    // Without a meter the whole run is one block
+    const auto blockFrames = meter ? meterBlockFrames : numFrames;
+    for (size_t done = 0; done < numFrames; done += blockFrames) {
+        const auto n = std::min(blockFrames, numFrames - done);
+        for (size_t c = 0; c < numChannels; ++c) {
+            convertOut_[c] = chunks[c].samples.data() + offset + done;
+        }
+        conversion::deinterleave(interleaved + done * srcChannels, conversion::SampleFormat::S16NE, srcChannels, n,
+                                 convertOut_.data());
+        if (meter) {
+            meter->process(convertOut_.data(), n);
+        }
     }
 }
 
-RenderModel::RenderModel(sf::RenderWindow &window)
-    : window_(window), quadVertices_(sf::Quads, 0), waveVertices_(sf::LineStrip) {}
+template <typename T> void BasicFrame<T>::finalize() { fftw.calculateDFT(spectra.data(), dftStride); }
+
+template struct BasicPCMChunk<double>;
+template struct BasicPCMChunk<float>;
+template struct BasicFrame<double>;
+template struct BasicFrame<float>;
+
+namespace {
+
+// FewerBars keeps one bar in this many
+constexpr size_t reducedBarDivisor = 4;
+
+// The meter panel has a column per channel then one each for momentary and short-term loudness, with the levels
+// scaled linearly in decibels over its height
+constexpr float meterColumnWidth = 10.f;
+constexpr float meterGap = 4.f;
+constexpr double meterFloor = -60.;
+// True peaks above this turn their channel's bar red
+constexpr double clipThreshold = -1.;
+// The EBU R128 programme loudness
+constexpr double targetLoudness = -23.;
+
+} // namespace
+
+const char *renderQualityName(RenderQuality quality) noexcept {
+    switch (quality) {
+    case RenderQuality::Full:
+        return "full";
+    case RenderQuality::FewerBars:
+        return "fewer bars";
+    case RenderQuality::Decimated:
+        return "decimated waveform";
+    case RenderQuality::SmallerFFT:
+        return "smaller fft";
+    }
+    return "";
+}
+
+RenderModel::RenderModel(sf::RenderTarget &target)
+    : target_(target), vertexBuffer_(sf::Triangles, sf::VertexBuffer::Stream) {}
 
 void RenderModel::resize(size_t width, size_t height) {
     sf::FloatRect visibleArea(0, 0, width, height);
-    window_.setView(sf::View(visibleArea));
+    target_.setView(sf::View(visibleArea));
+}
+
+void RenderModel::setWaveformMode(WaveformMode mode) noexcept { waveformMode_ = mode; }
+
+void RenderModel::setSpectrogram(size_t historyColumns, Colormap colormap) noexcept {
+    spectrogramHistory_ = historyColumns;
+    colormap_ = colormap;
+}
+
+void RenderModel::setSpectrum(SpectrumScale scale, size_t numBars, size_t sampleRate) noexcept {
+    spectrumScale_ = scale;
+    numBars_ = numBars;
+    sampleRate_ = sampleRate;
+}
+
+void RenderModel::useVertexBuffer(bool enable) noexcept {
+    preferVertexBuffer_ = enable;
+    bufferState_ = BufferState::Unchecked;
+    uploadAll_ = true;
+}
+
+const SpectrumLayout &RenderModel::spectrumLayout(size_t numBins, size_t numBars) {
+    if (!spectrumLayout_ || !spectrumLayout_->matches(numBins, numBars, spectrumScale_, sampleRate_)) {
+        spectrumLayout_.emplace(numBins, numBars, spectrumScale_, sampleRate_);
+        spectrumPrefix_.resize(numBins + 1);
+        barValues_.resize(numBars);
+    }
+    return *spectrumLayout_;
+}
+
+RenderModel::Lane RenderModel::lane(size_t channel, size_t numChannels, unsigned height) noexcept {
+    if (numChannels == 2) {
+        return Lane{0.f, static_cast<float>(height), channel == 0};
+    }
+    const auto top = static_cast<float>(channel * height) / numChannels;
+    const auto bottom = static_cast<float>((channel + 1) * height) / numChannels;
+    return Lane{top, bottom - top, false};
+}
+
+// Shrinking keeps the capacity, so switching modes back and forth doesn't reallocate
+void RenderModel::prepareVertices(size_t numBarVertices, size_t numWaveVertices, size_t numMeterVertices) {
+    if (numBarVertices_ == numBarVertices &&
+        vertices_.size() == numBarVertices + numWaveVertices + numMeterVertices) {
+        return;
+    }
+    // Meter vertices are coloured as they're built
+    vertices_.resize(numBarVertices + numWaveVertices + numMeterVertices);
+    for (size_t i = 0; i < vertices_.size(); ++i) {
+        vertices_[i].color = i < numBarVertices ? fftColor : waveColor;
+    }
+    numBarVertices_ = numBarVertices;
+    numMeterVertices_ = numMeterVertices;
+    barPlacement_ = BarPlacement{};
+    panelPlacement_ = PanelPlacement{};
+    uploadAll_ = true;
+}
+
+size_t RenderModel::numBarsFor(unsigned width) const noexcept {
+    const size_t numBars = numBars_ ? numBars_ : width;
+    return quality_ >= RenderQuality::FewerBars ? std::max<size_t>(numBars / reducedBarDivisor, 1) : numBars;
+}
+
+void RenderModel::showHistory(const SignalHistory *history, const HistoryView &view) noexcept {
+    history_ = history;
+    historyView_ = view;
+}
+
+void RenderModel::buildGeometry(const Frame &frame, unsigned width, unsigned height) {
+    const auto numDFTRects = numBarsFor(width);
+    const bool fromHistory = history_ && (!historyView_.live || historyView_.spanFrames != frame.numSamples);
+    assert(!fromHistory || history_->numChannels() == frame.numChannels);
+    decimate_ = fromHistory || waveformMode_ == WaveformMode::Envelope || quality_ >= RenderQuality::Decimated ||
+                frame.numSamples > maxFullWaveformSamples ||
+                (waveformMode_ == WaveformMode::Auto && frame.numSamples > width);
+    const auto numBarVertices =
+        spectrumView_ == SpectrumView::Bars ? verticesPerBar * numDFTRects * frame.numChannels : 0;
+    if (decimate_) {
+        waveVerticesPerChannel_ = verticesPerSegment * (std::max(width, 1u) - 1);
+        envelopeMin_.resize(width);
+        envelopeMax_.resize(width);
+        if (fromHistory) {
+            historySummaries_.resize(width);
+        }
+    } else {
+        waveVerticesPerChannel_ = verticesPerSegment * frame.numSamples;
+    }
+    // A quad for the panel, a bar and a true peak marker per channel, two loudness bars and the integrated and target
+    // lines
+    const auto numMeterVertices = meter_ ? verticesPerQuad * (2 * meter_->numChannels() + 5) : 0;
+    prepareVertices(numBarVertices, waveVerticesPerChannel_ * frame.numChannels, numMeterVertices);
+    if (spectrumView_ == SpectrumView::Bars) {
+        buildSpectrum(frame, width, height);
+    } else {
+        buildSpectrogramColumn(frame, height);
+    }
+    for (size_t c = 0; c < frame.numChannels; ++c) {
+        const auto &chunk = frame.getChunk(c);
+        const auto channelLane = lane(c, frame.numChannels, height);
+        auto *out = vertices_.data() + numBarVertices_ + c * waveVerticesPerChannel_;
+        if (fromHistory) {
+            buildHistoryEnvelope(c, out, width, channelLane);
+        } else if (decimate_) {
+            buildEnvelope(chunk, out, width, channelLane);
+        } else {
+            buildWaveform(chunk, out, width, channelLane);
+        }
+    }
+    if (meter_) {
+        buildMeters(vertices_.data() + vertices_.size() - numMeterVertices, width, height);
+    }
 }
 
-void RenderModel::prepareVertexArrays(size_t numQuadVertices, size_t numWaveVertices) {
-    const auto oldNumQuadVertices = quadVertices_.getVertexCount();
-    const auto oldNumWaveVertices = waveVertices_.getVertexCount();
-    if (oldNumQuadVertices != numQuadVertices) {
-        quadVertices_.resize(numQuadVertices);
+void RenderModel::drawFrame(const Frame &frame, bool newAudio) {
+    target_.clear(backgroundColor);
+    auto targetDimensions = target_.getSize();
+    buildGeometry(frame, targetDimensions.x, targetDimensions.y);
+    if (spectrumView_ == SpectrumView::Spectrogram) {
+        spectrogram_.configure(spectrogramHistory_, spectrogramColumn_.size(), colormap_);
+        if (newAudio) {
+            spectrogram_.push(spectrogramColumn_.data());
+        }
+        spectrogram_.draw(target_, sf::FloatRect(0, 0, targetDimensions.x, targetDimensions.y));
     }
-    if (oldNumWaveVertices != numWaveVertices) {
-        waveVertices_.resize(numWaveVertices);
+    drawVertices();
+}
+
+void RenderModel::drawVertices() {
+    if (bufferState_ == BufferState::Unchecked) {
+        // Asked lazily, as it needs a GL context and building geometry alone doesn't
+        bufferState_ =
+            preferVertexBuffer_ && sf::VertexBuffer::isAvailable() ? BufferState::Available : BufferState::Unavailable;
     }
-    if (oldNumQuadVertices < numQuadVertices) {
-        for (auto i = oldNumQuadVertices; i < numQuadVertices; ++i) {
-            quadVertices_[i].color = fftColor;
+    if (bufferState_ == BufferState::Available && vertexBuffer_.getVertexCount() < vertices_.size()) {
+        if (!vertexBuffer_.create(vertices_.size())) {
+            bufferState_ = BufferState::Unavailable;
         }
+        uploadAll_ = true;
     }
-    if (oldNumWaveVertices < numWaveVertices) {
-        for (auto i = oldNumWaveVertices; i < numWaveVertices; ++i) {
-            waveVertices_[i].color = waveColor;
+    if (bufferState_ == BufferState::Available) {
+        if (uploadAll_) {
+            vertexBuffer_.update(vertices_.data(), vertices_.size(), 0);
+            uploadAll_ = false;
+        } else {
+            // Everything up to the meter panel, then the meters over it. Every triangle of a bar has a vertex on its
+            // moving edge, so a bar's fixed edge can't be split off into a range of its own.
+            const auto panelBegin = vertices_.size() - numMeterVertices_;
+            vertexBuffer_.update(vertices_.data(), panelBegin, 0);
+            if (numMeterVertices_ > 0) {
+                const auto metersBegin = panelBegin + verticesPerQuad;
+                vertexBuffer_.update(vertices_.data() + metersBegin, vertices_.size() - metersBegin, metersBegin);
+            }
         }
+        // One draw for every channel's bars and waveform and the meters
+        target_.draw(vertexBuffer_, 0, vertices_.size());
+    } else {
+        target_.draw(vertices_.data(), vertices_.size(), sf::Triangles);
     }
 }
 
-void RenderModel::drawFrame(const Frame &frame) {
-    window_.clear(backgroundColor);
-    auto windowDimensions = window_.getSize();
-    auto width = windowDimensions.x;
-    auto height = windowDimensions.y;
-    const auto numDFTRects = 128u;
-    prepareVertexArrays(4 * numDFTRects, frame.numSamples + 1);
-    // draw the dft
-    for (auto channel : AudioChannels) {
-        const auto &chunk = frame.getChunk(channel);
-        auto &quads = quadVertices_;
+void RenderModel::buildSpectrum(const Frame &frame, unsigned width, unsigned height) {
+    const auto numDFTRects = numBarsFor(width);
+    const auto &layout = spectrumLayout(frame.fftw.numBins, numDFTRects);
+    // Bars only move horizontally when the layout changes, so x is written once and each frame only updates y
+    const BarPlacement placement{width, numDFTRects, frame.numChannels};
+    if (!(barPlacement_ == placement)) {
+        for (size_t c = 0; c < frame.numChannels; ++c) {
+            for (size_t i = 0; i < numDFTRects; ++i) {
+                const float x1 = (i * width) / numDFTRects;
+                const float x2 = ((i + 1) * width) / numDFTRects;
+                auto *bar = &vertices_[verticesPerBar * (c * numDFTRects + i)];
+                const float xs[verticesPerBar] = {x1, x1, x2, x1, x2, x2};
+                for (size_t v = 0; v < verticesPerBar; ++v) {
+                    bar[v].position.x = xs[v];
+                }
+            }
+        }
+        barPlacement_ = placement;
+    }
+    for (size_t c = 0; c < frame.numChannels; ++c) {
+        const auto &chunk = frame.getChunk(c);
+        const auto channelLane = lane(c, frame.numChannels, height);
+        const auto laneBottom = channelLane.top + channelLane.height;
+        auto *bars = &vertices_[verticesPerBar * numDFTRects * c];
+        layout.compute(chunk.dft.data(), spectrumPrefix_.data(), barValues_.data());
         for (auto i = 0u; i < numDFTRects; ++i) {
-            double value = chunk.getDftValueOverRange(i, i + 1, numDFTRects);
-            auto y = value * height / 2.;
-            auto x1 = (i * width) / numDFTRects;
-            auto x2 = ((i + 1) * width) / numDFTRects;
-            auto y1 = channel == AudioChannel::Left ? 0 : height - y;
-            auto y2 = channel == AudioChannel::Left ? y : height;
-            auto *quad = &quads[4 * i];
-            quad[0].position = sf::Vector2f(x1, y1);
-            quad[1].position = sf::Vector2f(x1, y2);
-            quad[2].position = sf::Vector2f(x2, y2);
-            quad[3].position = sf::Vector2f(x2, y1);
+            double value = barValues_[i];
+            auto y = value * channelLane.height / 2.;
+            const float y1 = channelLane.spectrumFromTop ? channelLane.top : laneBottom - y;
+            const float y2 = channelLane.spectrumFromTop ? channelLane.top + y : laneBottom;
+            auto *bar = &bars[verticesPerBar * i];
+            bar[0].position.y = y1;
+            bar[1].position.y = y2;
+            bar[2].position.y = y2;
+            bar[3].position.y = y1;
+            bar[4].position.y = y2;
+            bar[5].position.y = y1;
         }
-        window_.draw(quads);
-    }
-    // draw the audio waveform
-    for (auto channel : AudioChannels) {
-        auto &chunk = frame.getChunk(channel);
-        auto &line = waveVertices_;
-        line[0].position = sf::Vector2f(0., height / 2.);
-        for (auto i = 0u; i < frame.numSamples; ++i) {
-            double x = ((i + 1) * width) / ((double)frame.numSamples);
-            double y = (height * (1. - chunk.samples[i])) / 2.;
-            line[i + 1].position = sf::Vector2f(x, y);
+    }
+}
+
+void RenderModel::buildSpectrogramColumn(const Frame &frame, unsigned height) {
+    const auto numRows = numBars_ ? numBars_ : height;
+    const auto &layout = spectrumLayout(frame.fftw.numBins, numRows);
+    spectrogramColumn_.assign(numRows, 0.);
+    for (size_t c = 0; c < frame.numChannels; ++c) {
+        layout.compute(frame.getChunk(c).dft.data(), spectrumPrefix_.data(), barValues_.data());
+        for (size_t i = 0; i < numRows; ++i) {
+            spectrogramColumn_[i] += barValues_[i] / frame.numChannels;
         }
-        window_.draw(line);
     }
 }
 
+namespace {
+
+// Two triangles between the edges (a1, a2) and (b1, b2)
+void writeSegment(sf::Vertex *out, sf::Vector2f a1, sf::Vector2f a2, sf::Vector2f b1, sf::Vector2f b2) {
+    out[0].position = a1;
+    out[1].position = a2;
+    out[2].position = b2;
+    out[3].position = a1;
+    out[4].position = b2;
+    out[5].position = b1;
+}
+
+sf::Vertex *writeQuad(sf::Vertex *out, float x1, float y1, float x2, float y2, sf::Color color) {
+    writeSegment(out, {x1, y1}, {x1, y2}, {x2, y1}, {x2, y2});
+    for (size_t v = 0; v < 6; ++v) {
+        out[v].color = color;
+    }
+    return out + 6;
+}
+
+} // namespace
+
+// Each segment of the line becomes a one pixel wide quad, so it can share the triangle list with everything else
+void RenderModel::buildWaveform(const PCMChunk &chunk, sf::Vertex *out, unsigned width, Lane lane) {
+    const auto numSamples = chunk.samples.size();
+    sf::Vector2f previous(0., lane.top + lane.height / 2.);
+    for (auto i = 0u; i < numSamples; ++i) {
+        const sf::Vector2f point(((i + 1) * width) / ((double)numSamples),
+                                 lane.top + (lane.height * (1. - chunk.samples[i])) / 2.);
+        const auto d = point - previous;
+        const auto length = std::sqrt(d.x * d.x + d.y * d.y);
+        const auto normal = length > 0.f ? sf::Vector2f(-d.y, d.x) * (.5f / length) : sf::Vector2f(0.f, .5f);
+        writeSegment(out + verticesPerSegment * i, previous + normal, previous - normal, point + normal,
+                     point - normal);
+        previous = point;
+    }
+}
+
+void RenderModel::buildEnvelope(const PCMChunk &chunk, sf::Vertex *out, unsigned width, Lane lane) {
+    chunk.minMaxEnvelope(width, envelopeMin_.data(), envelopeMax_.data());
+    writeEnvelope(out, width, lane);
+}
+
+void RenderModel::buildHistoryEnvelope(size_t channel, sf::Vertex *out, unsigned width, Lane lane) {
+    const auto end = historyView_.live ? history_->framesWritten() : historyView_.endFrame;
+    history_->summarise(channel, end, historyView_.spanFrames, width, historySummaries_.data());
+    for (auto x = 0u; x < width; ++x) {
+        envelopeMin_[x] = historySummaries_[x].min;
+        envelopeMax_[x] = historySummaries_[x].max;
+    }
+    writeEnvelope(out, width, lane);
+}
+
+// Joins the min/max span of each pixel column to the next, which fills the same area the triangle strip used to
+void RenderModel::writeEnvelope(sf::Vertex *out, unsigned width, Lane lane) {
+    sf::Vector2f previousTop, previousBottom;
+    for (auto x = 0u; x < width; ++x) {
+        double top = lane.top + (lane.height * (1. - envelopeMax_[x])) / 2.;
+        double bottom = lane.top + (lane.height * (1. - envelopeMin_[x])) / 2.;
+        // keep quiet stretches visible as a one pixel line
+        if (bottom - top < 1.) {
+            const auto middle = (top + bottom) / 2.;
+            top = middle - .5;
+            bottom = middle + .5;
+        }
+        const sf::Vector2f columnTop(x + .5, top);
+        const sf::Vector2f columnBottom(x + .5, bottom);
+        if (x > 0) {
+            writeSegment(out + verticesPerSegment * (x - 1), previousTop, previousBottom, columnTop, columnBottom);
+        }
+        previousTop = columnTop;
+        previousBottom = columnBottom;
+    }
+}
+
+void RenderModel::buildMeters(sf::Vertex *out, unsigned width, unsigned height) {
+    const auto numChannels = meter_->numChannels();
+    const auto numColumns = numChannels + 2;
+    const float panelWidth = numColumns * (meterColumnWidth + meterGap) + meterGap;
+    const float left = std::max(0.f, width - panelWidth);
+    const float top = meterGap;
+    const float bottom = std::max(top, height - meterGap);
+    // Levels below the floor, including silence at -infinity, sit on the bottom
+    auto yFor = [&](double decibels) {
+        const auto fraction = std::clamp((decibels - meterFloor) / -meterFloor, 0., 1.);
+        return static_cast<float>(bottom - fraction * (bottom - top));
+    };
+    auto columnLeft = [&](size_t column) { return left + meterGap + column * (meterColumnWidth + meterGap); };
+    // Only moves with the window's size, and isn't uploaded again until it does
+    const PanelPlacement placement{width, height};
+    if (!(panelPlacement_ == placement)) {
+        writeQuad(out, left, 0.f, static_cast<float>(width), static_cast<float>(height), meterPanelColor);
+        panelPlacement_ = placement;
+        uploadAll_ = true;
+    }
+    out += verticesPerQuad;
+    for (size_t c = 0; c < numChannels; ++c) {
+        const auto &levels = meter_->levels(c);
+        const auto x1 = columnLeft(c);
+        const auto x2 = x1 + meterColumnWidth;
+        const auto truePeak = toDecibels(levels.truePeak);
+        out = writeQuad(out, x1, yFor(toDecibels(levels.rms)), x2, bottom,
+                        truePeak > clipThreshold ? clipColor : meterColor);
+        const auto peakY = yFor(truePeak);
+        out = writeQuad(out, x1, peakY - 1.f, x2, peakY + 1.f, waveColor);
+    }
+    const auto loudness = meter_->loudness();
+    const auto momentaryLeft = columnLeft(numChannels);
+    const auto shortTermLeft = columnLeft(numChannels + 1);
+    const auto loudnessRight = shortTermLeft + meterColumnWidth;
+    out = writeQuad(out, momentaryLeft, yFor(loudness.momentary), momentaryLeft + meterColumnWidth, bottom,
+                    loudnessColor);
+    out = writeQuad(out, shortTermLeft, yFor(loudness.shortTerm), loudnessRight, bottom, loudnessColor);
+    const auto integratedY = yFor(loudness.integrated);
+    out = writeQuad(out, momentaryLeft, integratedY - 1.f, loudnessRight, integratedY + 1.f, waveColor);
+    const auto targetY = yFor(targetLoudness);
+    writeQuad(out, momentaryLeft - meterGap / 2, targetY - .5f, loudnessRight + meterGap / 2, targetY + .5f, clipColor);
+}
+
 } // namespace PulseView
@@ -0,0 +1,255 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <cassert>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PULSEVIEW_X86 1
+#include <immintrin.h>
+#endif
+
+#include "sample_conversion.h"
+
+namespace PulseView::conversion {
+
+namespace {
+
+constexpr int16_t s16Max = std::numeric_limits<int16_t>::max();
+constexpr int32_t s32Max = std::numeric_limits<int32_t>::max();
+
+template <typename Out, typename T>
+void deinterleaveScalar(const T *in, Out scale, size_t numChannels, size_t numFrames, Out *const *out, size_t start) {
+    for (size_t i = start; i < numFrames; ++i) {
+        const auto *frame = in + numChannels * i;
+        for (size_t c = 0; c < numChannels; ++c) {
+            out[c][i] = static_cast<Out>(frame[c]) / scale;
+        }
+    }
+}
+
+template <typename Out>
+void deinterleaveScalar(const void *in, SampleFormat format, size_t numChannels, size_t numFrames, Out *const *out,
+                        size_t start = 0) {
+    switch (format) {
+    case SampleFormat::S16NE:
+        deinterleaveScalar<Out>(static_cast<const int16_t *>(in), s16Max, numChannels, numFrames, out, start);
+        break;
+    case SampleFormat::S32NE:
+        deinterleaveScalar<Out>(static_cast<const int32_t *>(in), s32Max, numChannels, numFrames, out, start);
+        break;
+    case SampleFormat::F32NE:
+        deinterleaveScalar<Out>(static_cast<const float *>(in), 1, numChannels, numFrames, out, start);
+        break;
+    }
+}
+
+#ifdef PULSEVIEW_X86
+
+// Each kernel converts as many whole vectors as it can and returns the index of the first frame it didn't convert
+
+size_t s16MonoSSE2(const int16_t *in, size_t numFrames, double *out) {
+    const __m128d scale = _mm_set1_pd(s16Max);
+    size_t i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        // sign extend by placing each sample in the top half of a 32 bit lane, then shifting it back down
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_pd(out + i, _mm_div_pd(_mm_cvtepi32_pd(lo), scale));
+        _mm_storeu_pd(out + i + 2, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(lo, 8)), scale));
+        _mm_storeu_pd(out + i + 4, _mm_div_pd(_mm_cvtepi32_pd(hi), scale));
+        _mm_storeu_pd(out + i + 6, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(hi, 8)), scale));
+    }
+    return i;
+}
+
+size_t s16StereoSSE2(const int16_t *in, size_t numFrames, double *left, double *right) {
+    const __m128d scale = _mm_set1_pd(s16Max);
+    size_t i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i));
+        // L0 R0 L1 R1 -> L0 L1 R0 R1
+        const __m128i lo = _mm_shuffle_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), _MM_SHUFFLE(3, 1, 2, 0));
+        const __m128i hi = _mm_shuffle_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_pd(left + i, _mm_div_pd(_mm_cvtepi32_pd(lo), scale));
+        _mm_storeu_pd(right + i, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(lo, 8)), scale));
+        _mm_storeu_pd(left + i + 2, _mm_div_pd(_mm_cvtepi32_pd(hi), scale));
+        _mm_storeu_pd(right + i + 2, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(hi, 8)), scale));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t s16MonoAVX2(const int16_t *in, size_t numFrames, double *out) {
+    const __m256d scale = _mm256_set1_pd(s16Max);
+    size_t i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)));
+        _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(v)), scale));
+        _mm256_storeu_pd(out + i + 4, _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)), scale));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t s16StereoAVX2(const int16_t *in, size_t numFrames, double *left,
+                                                     double *right) {
+    const __m256d scale = _mm256_set1_pd(s16Max);
+    // L0 R0 L1 R1 L2 R2 L3 R3 -> L0 L1 L2 L3 R0 R1 R2 R3
+    const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    size_t i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i)));
+        const __m256i lr = _mm256_permutevar8x32_epi32(v, split);
+        _mm256_storeu_pd(left + i, _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(lr)), scale));
+        _mm256_storeu_pd(right + i, _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(lr, 1)), scale));
+    }
+    return i;
+}
+
+size_t s16MonoSSE2(const int16_t *in, size_t numFrames, float *out) {
+    const __m128 scale = _mm_set1_ps(s16Max);
+    size_t i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_ps(out + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), scale));
+        _mm_storeu_ps(out + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)), scale));
+    }
+    return i;
+}
+
+size_t s16StereoSSE2(const int16_t *in, size_t numFrames, float *left, float *right) {
+    const __m128 scale = _mm_set1_ps(s16Max);
+    size_t i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i));
+        // L0 R0 L1 R1 -> L0 L1 R0 R1, then the low and high halves of both give L0..L3 and R0..R3
+        const __m128i lo = _mm_shuffle_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), _MM_SHUFFLE(3, 1, 2, 0));
+        const __m128i hi = _mm_shuffle_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_ps(left + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi64(lo, hi)), scale));
+        _mm_storeu_ps(right + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi64(lo, hi)), scale));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t s16MonoAVX2(const int16_t *in, size_t numFrames, float *out) {
+    const __m256 scale = _mm256_set1_ps(s16Max);
+    size_t i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)));
+        _mm256_storeu_ps(out + i, _mm256_div_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t s16StereoAVX2(const int16_t *in, size_t numFrames, float *left,
+                                                     float *right) {
+    const __m256 scale = _mm256_set1_ps(s16Max);
+    const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    size_t i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m256i lo = _mm256_permutevar8x32_epi32(
+            _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i))), split);
+        const __m256i hi = _mm256_permutevar8x32_epi32(
+            _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i + 8))), split);
+        const __m256 l = _mm256_cvtepi32_ps(_mm256_permute2x128_si256(lo, hi, 0x20));
+        const __m256 r = _mm256_cvtepi32_ps(_mm256_permute2x128_si256(lo, hi, 0x31));
+        _mm256_storeu_ps(left + i, _mm256_div_ps(l, scale));
+        _mm256_storeu_ps(right + i, _mm256_div_ps(r, scale));
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+size_t bytesPerSample(SampleFormat format) noexcept {
+    switch (format) {
+    case SampleFormat::S16NE:
+        return sizeof(int16_t);
+    case SampleFormat::S32NE:
+        return sizeof(int32_t);
+    case SampleFormat::F32NE:
+    default:
+        return sizeof(float);
+    }
+}
+
+bool kernelSupported(Kernel kernel) noexcept {
+    switch (kernel) {
+#ifdef PULSEVIEW_X86
+    case Kernel::SSE2:
+        return __builtin_cpu_supports("sse2");
+    case Kernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    case Kernel::Scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+Kernel bestKernel() noexcept {
+    static const Kernel best = kernelSupported(Kernel::AVX2)   ? Kernel::AVX2
+                               : kernelSupported(Kernel::SSE2) ? Kernel::SSE2
+                                                               : Kernel::Scalar;
+    return best;
+}
+
+const char *kernelName(Kernel kernel) noexcept {
+    switch (kernel) {
+    case Kernel::SSE2:
+        return "sse2";
+    case Kernel::AVX2:
+        return "avx2";
+    case Kernel::Scalar:
+    default:
+        return "scalar";
+    }
+}
+
+namespace {
+
+template <typename Out>
+void deinterleaveWith(Kernel kernel, const void *in, SampleFormat format, size_t numChannels, size_t numFrames,
+                      Out *const *out) {
+    assert(kernelSupported(kernel));
+    size_t done = 0;
+#ifdef PULSEVIEW_X86
+    if (format == SampleFormat::S16NE && (numChannels == 1 || numChannels == 2)) {
+        const auto *samples = static_cast<const int16_t *>(in);
+        const bool stereo = numChannels == 2;
+        if (kernel == Kernel::AVX2) {
+            done = stereo ? s16StereoAVX2(samples, numFrames, out[0], out[1]) : s16MonoAVX2(samples, numFrames, out[0]);
+        } else if (kernel == Kernel::SSE2) {
+            done = stereo ? s16StereoSSE2(samples, numFrames, out[0], out[1]) : s16MonoSSE2(samples, numFrames, out[0]);
+        }
+    }
+#endif
+    deinterleaveScalar(in, format, numChannels, numFrames, out, done);
+}
+
+} // namespace
+
+void deinterleave(const void *in, SampleFormat format, size_t numChannels, size_t numFrames, double *const *out) {
+    deinterleaveWith(bestKernel(), in, format, numChannels, numFrames, out);
+}
+
+void deinterleave(const void *in, SampleFormat format, size_t numChannels, size_t numFrames, float *const *out) {
+    deinterleaveWith(bestKernel(), in, format, numChannels, numFrames, out);
+}
+
+void deinterleave(Kernel kernel, const void *in, SampleFormat format, size_t numChannels, size_t numFrames,
+                  double *const *out) {
+    deinterleaveWith(kernel, in, format, numChannels, numFrames, out);
+}
+
+void deinterleave(Kernel kernel, const void *in, SampleFormat format, size_t numChannels, size_t numFrames,
+                  float *const *out) {
+    deinterleaveWith(kernel, in, format, numChannels, numFrames, out);
+}
+
+} // namespace PulseView::conversion
@@ -0,0 +1,212 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "signal_history.h"
+
+namespace PulseView {
+
+namespace {
+
+constexpr float s16Max = std::numeric_limits<int16_t>::max();
+// Levels are added until the top one would hold fewer entries than this
+constexpr size_t minTopEntries = 64;
+
+size_t roundUp(size_t n, size_t multiple) noexcept { return (n + multiple - 1) / multiple * multiple; }
+
+} // namespace
+
+void SignalHistory::Accumulator::clear() noexcept {
+    min = std::numeric_limits<float>::infinity();
+    max = -std::numeric_limits<float>::infinity();
+    sumSquares = 0.;
+    count = 0;
+}
+
+void SignalHistory::Accumulator::add(float sample) noexcept {
+    min = std::min(min, sample);
+    max = std::max(max, sample);
+    sumSquares += sample * sample;
+    ++count;
+}
+
+void SignalHistory::Accumulator::add(const Entry &entry, uint64_t entryFrames) noexcept {
+    min = std::min(min, entry.min);
+    max = std::max(max, entry.max);
+    sumSquares += static_cast<double>(entry.meanSquare) * entryFrames;
+    count += entryFrames;
+}
+
+SignalHistory::SignalHistory(size_t numChannels, size_t capacityFrames, const std::string &backingPath)
+    : numChannels_{numChannels} {
+    if (numChannels_ == 0 || capacityFrames == 0) {
+        die("Signal history needs at least one channel and one frame");
+    }
+    uint64_t entryFrames = 1;
+    size_t numLevels = 1;
+    do {
+        entryFrames *= fanout;
+        ++numLevels;
+    } while (entryFrames * fanout * minTopEntries <= capacityFrames);
+    capacity_ = roundUp(capacityFrames, entryFrames);
+
+    size_t offset = roundUp(capacity_ * numChannels_ * sizeof(S16NESample), alignof(Entry));
+    levels_.push_back(Level{1, capacity_, nullptr});
+    for (size_t k = 1; k < numLevels; ++k) {
+        const auto frames = levels_.back().entryFrames * fanout;
+        levels_.push_back(Level{frames, capacity_ / frames, nullptr});
+        offset += levels_.back().numEntries * numChannels_ * sizeof(Entry);
+    }
+    mapSize_ = offset;
+
+    if (backingPath.empty()) {
+        // Pages are only committed as the history fills
+        map_ = mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    } else {
+        int fd = open(backingPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            PulseView::fail_errno("Failed to open " + backingPath + ": ");
+        }
+        if (ftruncate(fd, mapSize_) < 0) {
+            const int err = errno;
+            close(fd);
+            PulseView::fail_errno("Failed to size " + backingPath + ": ", err);
+        }
+        map_ = mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int err = errno;
+        close(fd);
+        errno = err;
+    }
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        PulseView::fail_errno("Failed to map the signal history: ");
+    }
+
+    auto *base = static_cast<unsigned char *>(map_);
+    raw_ = reinterpret_cast<S16NESample *>(base);
+    offset = roundUp(capacity_ * numChannels_ * sizeof(S16NESample), alignof(Entry));
+    for (size_t k = 1; k < levels_.size(); ++k) {
+        levels_[k].entries = reinterpret_cast<Entry *>(base + offset);
+        offset += levels_[k].numEntries * numChannels_ * sizeof(Entry);
+    }
+    pending_.resize(levels_.size() * numChannels_);
+    for (auto &acc : pending_) {
+        acc.clear();
+    }
+}
+
+SignalHistory::~SignalHistory() noexcept {
+    if (map_) {
+        munmap(map_, mapSize_);
+        map_ = nullptr;
+    }
+}
+
+void SignalHistory::append(const S16NESample *interleaved, size_t numFrames) {
+    auto *level1 = pending_.data() + numChannels_;
+    for (size_t f = 0; f < numFrames; ++f) {
+        const auto *frame = interleaved + f * numChannels_;
+        const auto slot = framesWritten_ % capacity_;
+        for (size_t c = 0; c < numChannels_; ++c) {
+            raw_[c * capacity_ + slot] = frame[c];
+            level1[c].add(frame[c] / s16Max);
+        }
+        ++framesWritten_;
+        // Close every entry this frame completed, each one feeding the level above
+        for (size_t k = 1; k < levels_.size() && framesWritten_ % levels_[k].entryFrames == 0; ++k) {
+            const auto &level = levels_[k];
+            const auto slotInLevel = (framesWritten_ / level.entryFrames - 1) % level.numEntries;
+            for (size_t c = 0; c < numChannels_; ++c) {
+                auto &acc = pending_[k * numChannels_ + c];
+                const Entry closed{acc.min, acc.max, static_cast<float>(acc.sumSquares / acc.count)};
+                level.entries[c * level.numEntries + slotInLevel] = closed;
+                if (k + 1 < levels_.size()) {
+                    pending_[(k + 1) * numChannels_ + c].add(closed, level.entryFrames);
+                }
+                acc.clear();
+            }
+        }
+    }
+}
+
+const SignalHistory::Entry &SignalHistory::entry(size_t level, size_t channel, uint64_t index) const noexcept {
+    const auto &l = levels_[level];
+    return l.entries[channel * l.numEntries + index % l.numEntries];
+}
+
+// Whole entries of level cover the middle of the range, the ragged ends are left to the levels below
+void SignalHistory::accumulate(size_t channel, uint64_t begin, uint64_t end, size_t level, Accumulator &acc) const {
+    if (begin >= end) {
+        return;
+    }
+    if (level == 0) {
+        const auto *samples = raw_ + channel * capacity_;
+        for (auto f = begin; f < end; ++f) {
+            acc.add(samples[f % capacity_] / s16Max);
+        }
+        return;
+    }
+    const auto size = levels_[level].entryFrames;
+    const auto first = (begin + size - 1) / size;
+    const auto last = end / size;
+    if (first >= last) {
+        accumulate(channel, begin, end, level - 1, acc);
+        return;
+    }
+    accumulate(channel, begin, first * size, level - 1, acc);
+    for (auto i = first; i < last; ++i) {
+        acc.add(entry(level, channel, i), size);
+    }
+    accumulate(channel, last * size, end, level - 1, acc);
+}
+
+void SignalHistory::copyNewest(S16NESample *interleaved, size_t numFrames) const noexcept {
+    const auto held = std::min<uint64_t>(numFrames, framesWritten_ - oldestFrame());
+    const auto silent = numFrames - held;
+    std::fill(interleaved, interleaved + silent * numChannels_, 0);
+    for (uint64_t f = framesWritten_ - held, out = silent * numChannels_; f < framesWritten_; ++f) {
+        const auto slot = f % capacity_;
+        for (size_t c = 0; c < numChannels_; ++c) {
+            interleaved[out++] = raw_[c * capacity_ + slot];
+        }
+    }
+}
+
+void SignalHistory::summarise(size_t channel, uint64_t end, uint64_t spanFrames, size_t numColumns,
+                              SampleSummary *out) const {
+    if (numColumns == 0) {
+        return;
+    }
+    // The coarsest level whose entries still fit in a column
+    const auto columnFrames = spanFrames / numColumns;
+    size_t level = 0;
+    while (level + 1 < levels_.size() && levels_[level + 1].entryFrames <= columnFrames) {
+        ++level;
+    }
+    const auto held = static_cast<int64_t>(oldestFrame());
+    const auto newest = static_cast<int64_t>(std::min(end, framesWritten_));
+    const auto start = static_cast<int64_t>(end) - static_cast<int64_t>(spanFrames);
+    Accumulator acc;
+    for (size_t i = 0; i < numColumns; ++i) {
+        const auto begin = std::max(start + static_cast<int64_t>(i * spanFrames / numColumns), held);
+        const auto finish = std::min(start + static_cast<int64_t>((i + 1) * spanFrames / numColumns), newest);
+        acc.clear();
+        if (begin < finish) {
+            accumulate(channel, begin, finish, level, acc);
+        }
+        out[i] = acc.count ? SampleSummary{acc.min, acc.max, static_cast<float>(std::sqrt(acc.sumSquares / acc.count))}
+                           : SampleSummary{0.f, 0.f, 0.f};
+    }
+}
+
+} // namespace PulseView
@@ -0,0 +1,117 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "pulseview.h"
+#include "spectrogram.h"
+
+namespace PulseView {
+
+namespace {
+
+struct ColorStop {
+    float position;
+    sf::Uint8 r, g, b;
+};
+
+// Piecewise linear approximations of each map, inferno and viridis sampled from matplotlib's
+const std::vector<ColorStop> &colorStops(Colormap colormap) {
+    static const std::vector<ColorStop> grayscale{{0.f, 0, 0, 0}, {1.f, 255, 255, 255}};
+    static const std::vector<ColorStop> heat{
+        {0.f, 0, 0, 0}, {.35f, 190, 0, 0}, {.7f, 255, 200, 0}, {1.f, 255, 255, 255}};
+    static const std::vector<ColorStop> inferno{
+        {0.f, 0, 0, 4}, {.25f, 87, 16, 110}, {.5f, 188, 55, 84}, {.75f, 249, 142, 9}, {1.f, 252, 255, 164}};
+    static const std::vector<ColorStop> viridis{
+        {0.f, 68, 1, 84}, {.25f, 59, 82, 139}, {.5f, 33, 145, 140}, {.75f, 94, 201, 98}, {1.f, 253, 231, 37}};
+    switch (colormap) {
+    case Colormap::Grayscale:
+        return grayscale;
+    case Colormap::Heat:
+        return heat;
+    case Colormap::Viridis:
+        return viridis;
+    case Colormap::Inferno:
+    default:
+        return inferno;
+    }
+}
+
+sf::Color interpolate(const std::vector<ColorStop> &stops, float position) {
+    auto upper = std::lower_bound(stops.begin() + 1, stops.end() - 1, position,
+                                  [](const ColorStop &stop, float p) { return stop.position < p; });
+    const auto &lo = *(upper - 1);
+    const auto &hi = *upper;
+    const float t = std::clamp((position - lo.position) / (hi.position - lo.position), 0.f, 1.f);
+    auto lerp = [t](sf::Uint8 a, sf::Uint8 b) { return static_cast<sf::Uint8>(std::lround(a + t * (b - a))); };
+    return sf::Color{lerp(lo.r, hi.r), lerp(lo.g, hi.g), lerp(lo.b, hi.b)};
+}
+
+void writePixel(sf::Uint8 *pixel, const sf::Color &color) {
+    pixel[0] = color.r;
+    pixel[1] = color.g;
+    pixel[2] = color.b;
+    pixel[3] = 255;
+}
+
+} // namespace
+
+bool Spectrogram::matches(size_t numColumns, size_t numRows, Colormap colormap) const noexcept {
+    return numColumns_ == std::min<size_t>(numColumns, sf::Texture::getMaximumSize()) && numRows_ == numRows &&
+           colormap_ == colormap;
+}
+
+void Spectrogram::configure(size_t numColumns, size_t numRows, Colormap colormap) {
+    if (matches(numColumns, numRows, colormap)) {
+        return;
+    }
+    numColumns_ = std::min<size_t>(numColumns, sf::Texture::getMaximumSize());
+    numRows_ = numRows;
+    colormap_ = colormap;
+    next_ = 0;
+    const auto &stops = colorStops(colormap);
+    for (size_t i = 0; i < palette_.size(); ++i) {
+        palette_[i] = interpolate(stops, static_cast<float>(i) / (palette_.size() - 1));
+    }
+    if (!numColumns_ || !numRows_ || !texture_.create(numColumns_, numRows_)) {
+        numColumns_ = numRows_ = 0;
+        die("Failed to create the spectrogram texture");
+    }
+    // The coordinates run past the right edge and wrap back onto the oldest columns
+    texture_.setRepeated(true);
+    texture_.setSmooth(false);
+    // Start from silence rather than whatever the driver left in the texture
+    std::vector<sf::Uint8> silence(numColumns_ * numRows_ * 4);
+    for (size_t i = 0; i < numColumns_ * numRows_; ++i) {
+        writePixel(&silence[4 * i], palette_[0]);
+    }
+    texture_.update(silence.data());
+    column_.resize(numRows_ * 4);
+}
+
+void Spectrogram::push(const double *values) {
+    const auto maxIndex = palette_.size() - 1;
+    for (size_t row = 0; row < numRows_; ++row) {
+        const auto value = std::clamp(values[row], 0., 1.);
+        writePixel(&column_[4 * (numRows_ - 1 - row)], palette_[static_cast<size_t>(value * maxIndex + .5)]);
+    }
+    texture_.update(column_.data(), 1, numRows_, next_, 0);
+    next_ = (next_ + 1) % numColumns_;
+}
+
+void Spectrogram::draw(sf::RenderTarget &target, const sf::FloatRect &area) {
+    const float left = next_;
+    const float right = next_ + numColumns_;
+    quad_[0] = sf::Vertex{{area.left, area.top}, sf::Color::White, {left, 0.f}};
+    quad_[1] = sf::Vertex{{area.left + area.width, area.top}, sf::Color::White, {right, 0.f}};
+    quad_[2] = sf::Vertex{{area.left + area.width, area.top + area.height}, sf::Color::White,
+                          {right, static_cast<float>(numRows_)}};
+    quad_[3] = sf::Vertex{{area.left, area.top + area.height}, sf::Color::White, {left, static_cast<float>(numRows_)}};
+    target.draw(quad_, sf::RenderStates{&texture_});
+}
+
+} // namespace PulseView
@@ -0,0 +1,72 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "spectrum_layout.h"
+
+namespace PulseView {
+
+namespace {
+
+double hzToMel(double hz) { return 2595. * std::log10(1. + hz / 700.); }
+
+double melToHz(double mel) { return 700. * (std::pow(10., mel / 2595.) - 1.); }
+
+// Bin at the left edge of bar i, i.e. i / numBars of the way along the scale
+size_t edgeBin(size_t i, size_t numBars, size_t lastBin, SpectrumScale scale, size_t sampleRate) {
+    const double t = static_cast<double>(i) / numBars;
+    switch (scale) {
+    case SpectrumScale::Linear:
+        return (i * lastBin) / numBars;
+    case SpectrumScale::Logarithmic:
+        return i == 0 ? 0 : static_cast<size_t>(std::pow(static_cast<double>(lastBin), t));
+    case SpectrumScale::Mel: {
+        const double nyquist = sampleRate / 2.;
+        return static_cast<size_t>(melToHz(t * hzToMel(nyquist)) * lastBin / nyquist);
+    }
+    case SpectrumScale::Quadratic:
+    default:
+        return (i * i * lastBin) / (numBars * numBars);
+    }
+}
+
+} // namespace
+
+SpectrumLayout::SpectrumLayout(size_t numBins, size_t numBars, SpectrumScale scale, size_t sampleRate)
+    : numBins_{numBins}, numBars_{numBars}, scale_{scale}, sampleRate_{sampleRate}, edges_(numBars + 1) {
+    assert(numBins >= 2);
+    assert(numBars >= 1);
+    const auto lastBin = numBins - 1;
+    for (size_t i = 0; i <= numBars; ++i) {
+        edges_[i] = std::min(edgeBin(i, numBars, lastBin, scale, sampleRate), lastBin);
+    }
+    edges_[numBars] = numBins;
+}
+
+bool SpectrumLayout::matches(size_t numBins, size_t numBars, SpectrumScale scale, size_t sampleRate) const noexcept {
+    return numBins_ == numBins && numBars_ == numBars && scale_ == scale && sampleRate_ == sampleRate;
+}
+
+template <typename T> void SpectrumLayout::compute(const T *bins, double *prefix, double *bars) const noexcept {
+    prefix[0] = 0.;
+    for (size_t i = 0; i < numBins_; ++i) {
+        prefix[i + 1] = prefix[i] + bins[i];
+    }
+    for (size_t i = 0; i < numBars_; ++i) {
+        const auto i1 = edges_[i];
+        const auto i2 = std::max(edges_[i + 1], i1 + 1);
+        auto rv = (prefix[i2] - prefix[i1]) / (i2 - i1);
+        // make the returned value slightly nicer to parse
+        bars[i] = std::pow(rv, 0.7) / 32.;
+    }
+}
+
+template void SpectrumLayout::compute(const double *bins, double *prefix, double *bars) const noexcept;
+template void SpectrumLayout::compute(const float *bins, double *prefix, double *bars) const noexcept;
+
+} // namespace PulseView
@@ -0,0 +1,73 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "synthetic_source.h"
+
+namespace PulseView::AudioSource {
+
+namespace {
+
+// Half of full scale, so signals never clip
+constexpr double amplitude = 16384.;
+constexpr double chirpStart = 20.;
+constexpr double twoPi = 2. * M_PI;
+
+} // namespace
+
+SyntheticSource::SyntheticSource(Signal signal, size_t sampleRate, size_t numChannels, double frequency,
+                                 uint32_t seed)
+    : signal_{signal}, sampleRate_{sampleRate}, numChannels_{numChannels}, frequency_{frequency},
+      state_{seed ? seed : 1} {}
+
+void SyntheticSource::populateFrame(PulseView::Frame &frame) {
+    buffer_.resize(numChannels_ * frame.numSamples);
+    read(buffer_.data(), frame.numSamples);
+    frame.loadInterleaved(buffer_.data(), numChannels_);
+    frame.finalize();
+}
+
+S16NESample SyntheticSource::nextTone() noexcept {
+    auto frequency = frequency_;
+    if (signal_ == Signal::Chirp) {
+        const auto t = static_cast<double>(position_ % sampleRate_) / sampleRate_;
+        frequency = chirpStart + (frequency_ - chirpStart) * t;
+    }
+    const auto sample = static_cast<S16NESample>(amplitude * std::sin(phase_));
+    // Wrapping keeps the phase precise however long the source runs
+    phase_ = std::fmod(phase_ + twoPi * frequency / sampleRate_, twoPi);
+    return sample;
+}
+
+// xorshift32, chosen over <random> distributions because their output differs between standard libraries
+S16NESample SyntheticSource::nextNoise() noexcept {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return static_cast<S16NESample>(static_cast<int32_t>(state_ >> 16) - 32768) / 2;
+}
+
+void SyntheticSource::read(PulseView::S16NESample *buffer, size_t numFrames) {
+    switch (signal_) {
+    case Signal::Sine:
+    case Signal::Chirp:
+        for (size_t i = 0; i < numFrames; ++i, ++position_) {
+            std::fill_n(buffer + i * numChannels_, numChannels_, nextTone());
+        }
+        break;
+    case Signal::Noise:
+        std::generate_n(buffer, numFrames * numChannels_, [this] { return nextNoise(); });
+        position_ += numFrames;
+        break;
+    case Signal::Silence:
+        std::fill_n(buffer, numFrames * numChannels_, S16NESample{0});
+        position_ += numFrames;
+        break;
+    }
+}
+
+} // namespace PulseView::AudioSource
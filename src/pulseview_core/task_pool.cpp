@@ -0,0 +1,113 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+
+#include "task_pool.h"
+
+namespace PulseView {
+
+TaskPool::TaskPool(size_t numThreads) {
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads_.emplace_back(&TaskPool::work, this);
+    }
+}
+
+TaskPool::~TaskPool() noexcept {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        running_ = false;
+    }
+    wake_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+    if (postThread_.joinable()) {
+        postThread_.join();
+    }
+}
+
+TaskPool &TaskPool::shared() {
+    static TaskPool pool{std::max(std::thread::hardware_concurrency(), 1u) - 1};
+    return pool;
+}
+
+void TaskPool::run(size_t numTasks, TaskFn fn, void *context) {
+    std::lock_guard<std::mutex> runLock{runMutex_};
+    std::unique_lock<std::mutex> lock{mutex_};
+    fn_ = fn;
+    context_ = context;
+    numTasks_ = numTasks;
+    next_ = 0;
+    remaining_ = numTasks;
+    const auto generation = ++generation_;
+    if (numTasks > 1) {
+        wake_.notify_all();
+    }
+    drain(lock, generation);
+    done_.wait(lock, [this] { return remaining_ == 0; });
+}
+
+void TaskPool::post(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    posted_.push_back(std::move(task));
+    if (threads_.empty() && !postThread_.joinable()) {
+        postThread_ = std::thread{&TaskPool::runPosted, this};
+    }
+    wake_.notify_one();
+}
+
+void TaskPool::runPosted() noexcept {
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+        wake_.wait(lock, [&] { return !running_ || !posted_.empty(); });
+        if (!running_) {
+            return;
+        }
+        auto task = std::move(posted_.front());
+        posted_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void TaskPool::drain(std::unique_lock<std::mutex> &lock, uint64_t generation) {
+    // A thread that wakes late must not pick up tasks of a job that has since replaced the one it woke for
+    while (generation_ == generation && next_ < numTasks_) {
+        const auto i = next_++;
+        const auto fn = fn_;
+        auto *context = context_;
+        lock.unlock();
+        fn(context, i);
+        lock.lock();
+        if (--remaining_ == 0) {
+            done_.notify_all();
+        }
+    }
+}
+
+void TaskPool::work() noexcept {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+        wake_.wait(lock, [&] { return !running_ || generation_ != seen || !posted_.empty(); });
+        if (!running_) {
+            return;
+        }
+        if (generation_ != seen) {
+            seen = generation_;
+            drain(lock, seen);
+            continue;
+        }
+        auto task = std::move(posted_.front());
+        posted_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+} // namespace PulseView
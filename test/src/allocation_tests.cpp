@@ -0,0 +1,175 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+// Replaces the global operator new, so this file is built into its own test binary
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <capture_thread.h>
+#include <loudness_meter.h>
+#include <render_model.h>
+#include <synthetic_source.h>
+
+namespace {
+
+std::atomic<bool> countAllocations{false};
+std::atomic<size_t> allocationCount{0};
+
+void *countedAlloc(std::size_t size, std::size_t alignment) {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    size = size ? size : 1;
+    void *p = alignment > alignof(std::max_align_t)
+                  ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                  : std::malloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+} // namespace
+
+void *operator new(std::size_t size) { return countedAlloc(size, 0); }
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+using namespace PulseView;
+
+class AllocationTest : public ::testing::Test {
+  protected:
+    static constexpr size_t warmupFrames = 16;
+    static constexpr size_t measuredFrames = 1000;
+    static constexpr unsigned width = 800;
+    static constexpr unsigned height = 600;
+    static constexpr size_t hopFrames = 800;
+
+    // Runs one capture -> analyze -> geometry iteration straight off the source
+    void step() {
+        source.read(hop.data(), hopFrames);
+        frame.advance(hop.data(), hopFrames, source.numChannels());
+        frame.finalize();
+        model.buildGeometry(frame, width, height);
+    }
+
+    template <typename F> size_t countAllocationsIn(F &&f) {
+        allocationCount.store(0);
+        countAllocations.store(true);
+        f();
+        countAllocations.store(false);
+        return allocationCount.load();
+    }
+
+    // Never blocks, so the capture thread runs as fast as the ring allows
+    AudioSource::SyntheticSource source{AudioSource::Signal::Sine, 48000};
+    Frame frame{10, 2, fftw::PlannerEffort::Estimate};
+    // Never created, RenderModel only needs a target to exist to build geometry
+    sf::RenderTexture target;
+    RenderModel model{target};
+    std::vector<S16NESample> hop = std::vector<S16NESample>(hopFrames * 2);
+};
+
+TEST_F(AllocationTest, EnvelopeLoopDoesNotAllocate) {
+    model.setWaveformMode(WaveformMode::Envelope);
+    for (size_t i = 0; i < warmupFrames; ++i) {
+        step();
+    }
+    EXPECT_EQ(0u, countAllocationsIn([&] {
+                  for (size_t i = 0; i < measuredFrames; ++i) {
+                      step();
+                  }
+              }));
+}
+
+TEST_F(AllocationTest, FullWaveformLoopDoesNotAllocate) {
+    model.setWaveformMode(WaveformMode::Full);
+    model.setSpectrum(SpectrumScale::Mel, 0, 48000);
+    for (size_t i = 0; i < warmupFrames; ++i) {
+        step();
+    }
+    EXPECT_EQ(0u, countAllocationsIn([&] {
+                  for (size_t i = 0; i < measuredFrames; ++i) {
+                      step();
+                  }
+              }));
+}
+
+TEST_F(AllocationTest, CaptureThreadLoopDoesNotAllocate) {
+    CaptureThread capture{source, frame.numSamples, hopFrames};
+    auto nextFrame = [&] {
+        while (!capture.populateFrame(frame)) {
+            std::this_thread::yield();
+        }
+        model.buildGeometry(frame, width, height);
+    };
+    for (size_t i = 0; i < warmupFrames; ++i) {
+        nextFrame();
+    }
+    EXPECT_EQ(0u, countAllocationsIn([&] {
+                  for (size_t i = 0; i < measuredFrames; ++i) {
+                      nextFrame();
+                  }
+              }));
+}
+
+// Every block is metered as it's converted, the way live frames are
+TEST_F(AllocationTest, MeteredCaptureThreadLoopDoesNotAllocate) {
+    LoudnessMeter meter{source.numChannels(), 48000};
+    CaptureThread capture{source, frame.numSamples, hopFrames};
+    capture.setMeter(&meter);
+    auto nextFrame = [&] {
+        while (!capture.populateFrame(frame)) {
+            std::this_thread::yield();
+        }
+        model.buildGeometry(frame, width, height);
+    };
+    for (size_t i = 0; i < warmupFrames; ++i) {
+        nextFrame();
+    }
+    EXPECT_EQ(0u, countAllocationsIn([&] {
+                  for (size_t i = 0; i < measuredFrames; ++i) {
+                      nextFrame();
+                  }
+              }));
+}
+
+// Popping far less than the ring holds reads everything else through processInterleaved as stale audio
+TEST_F(AllocationTest, MeteringStaleAudioDoesNotAllocate) {
+    static constexpr size_t popFrames = 64;
+    LoudnessMeter meter{source.numChannels(), 48000};
+    CaptureThread capture{source, frame.numSamples, hopFrames};
+    capture.setMeter(&meter);
+    auto nextPop = [&] {
+        while (capture.pop(hop.data(), popFrames) == 0) {
+            std::this_thread::yield();
+        }
+    };
+    for (size_t i = 0; i < warmupFrames; ++i) {
+        nextPop();
+    }
+    const auto staleBefore = capture.metrics().staleFrames;
+    EXPECT_EQ(0u, countAllocationsIn([&] {
+                  for (size_t i = 0; i < measuredFrames; ++i) {
+                      nextPop();
+                  }
+              }));
+    EXPECT_GT(capture.metrics().staleFrames, staleBefore);
+}
+
+} // namespace
@@ -0,0 +1,71 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include <analysis_pipeline.h>
+#include <synthetic_source.h>
+
+namespace {
+
+using namespace PulseView;
+
+constexpr size_t log2WindowFrames = 10;
+constexpr size_t hopFrames = 256;
+
+// Updates until a new frame comes out of the pipeline
+const Frame *nextFrame(AnalysisPipeline &pipeline) {
+    while (!pipeline.update()) {
+        std::this_thread::yield();
+    }
+    return pipeline.newest();
+}
+
+TEST(AnalysisPipelineTest, AnalysesCapturedAudio) {
+    AudioSource::SyntheticSource source{AudioSource::Signal::Sine, 48000};
+    CaptureThread capture{source, size_t{1} << log2WindowFrames, hopFrames};
+    AnalysisPipeline pipeline{capture, source.numChannels(), log2WindowFrames, 2, fftw::PlannerEffort::Estimate};
+    EXPECT_EQ(nullptr, pipeline.newest());
+    for (size_t i = 0; i < 50; ++i) {
+        const auto *frame = nextFrame(pipeline);
+        ASSERT_NE(nullptr, frame);
+        const auto &samples = frame->getChunk(0).samples;
+        EXPECT_GT(*std::max_element(samples.begin(), samples.end()), 0.4);
+        // A 440 Hz sine peaks in the bin closest to 440 Hz
+        const auto &dft = frame->getChunk(0).dft;
+        const auto peak = std::max_element(dft.begin(), dft.end()) - dft.begin();
+        EXPECT_EQ(std::lround(440. * frame->numSamples / 48000), peak);
+    }
+    const auto metrics = pipeline.metrics();
+    EXPECT_GE(metrics.framesAnalysed, 50u);
+}
+
+TEST(AnalysisPipelineTest, SwitchesFFTSizeWithoutStopping) {
+    AudioSource::SyntheticSource source{AudioSource::Signal::Sine, 48000};
+    CaptureThread capture{source, size_t{1} << log2WindowFrames, hopFrames};
+    AnalysisPipeline pipeline{capture, source.numChannels(), log2WindowFrames, 2, fftw::PlannerEffort::Estimate};
+    for (size_t log2Size : {log2WindowFrames + 1, log2WindowFrames, log2WindowFrames + 1}) {
+        pipeline.setFFTSize(log2Size);
+        // Frames of the previous size keep coming until the new set is ready
+        const Frame *frame;
+        do {
+            frame = nextFrame(pipeline);
+        } while (frame->log2Size != log2Size);
+        const auto &dft = frame->getChunk(0).dft;
+        const auto peak = std::max_element(dft.begin(), dft.end()) - dft.begin();
+        EXPECT_EQ(std::lround(440. * frame->numSamples / 48000), peak);
+    }
+    // Only the first switch to the larger size planned anything
+    const auto metrics = pipeline.frameCacheMetrics();
+    EXPECT_EQ(metrics.misses, 2u);
+    EXPECT_EQ(metrics.hits, 2u);
+    EXPECT_EQ(metrics.evictions, 0u);
+}
+
+} // namespace
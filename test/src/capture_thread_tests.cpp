@@ -0,0 +1,55 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <condition_variable>
+#include <mutex>
+
+#include "gtest/gtest.h"
+
+#include <capture_thread.h>
+
+namespace {
+
+using namespace PulseView;
+
+// Never has anything to read, like an idle producer, until interrupted
+class SilentSource : public AudioSource::Source {
+  public:
+    void populateFrame(Frame &) {}
+    void read(S16NESample *, size_t) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        reading_ = true;
+        changed_.notify_all();
+        changed_.wait(lock, [this] { return interrupted_; });
+    }
+    size_t numChannels() const noexcept { return 2; }
+    void interrupt() noexcept {
+        std::lock_guard<std::mutex> lock{mutex_};
+        interrupted_ = true;
+        changed_.notify_all();
+    }
+    void waitUntilReading() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        changed_.wait(lock, [this] { return reading_; });
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool reading_{false};
+    bool interrupted_{false};
+};
+
+TEST(CaptureThreadTest, StopsWhileReadIsBlocked) {
+    SilentSource source;
+    {
+        CaptureThread capture{source, 1024, 256};
+        source.waitUntilReading();
+    }
+    // Reaching here at all means the destructor didn't hang
+    SUCCEED();
+}
+
+} // namespace
@@ -0,0 +1,120 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <file_source.h>
+
+namespace {
+
+using PulseView::S16NESample;
+using PulseView::AudioSource::FileSource;
+
+class TempFile {
+  public:
+    explicit TempFile(const std::vector<unsigned char> &bytes) {
+        char name[] = "/tmp/pulseview-test-XXXXXX";
+        const int fd = mkstemp(name);
+        EXPECT_GE(fd, 0);
+        EXPECT_EQ(static_cast<ssize_t>(bytes.size()), write(fd, bytes.data(), bytes.size()));
+        close(fd);
+        path_ = name;
+    }
+    ~TempFile() { unlink(path_.c_str()); }
+    const std::string &path() const noexcept { return path_; }
+
+  private:
+    std::string path_;
+};
+
+void appendLE(std::vector<unsigned char> &out, uint32_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void appendTag(std::vector<unsigned char> &out, const char *tag) { out.insert(out.end(), tag, tag + 4); }
+
+void appendSamples(std::vector<unsigned char> &out, const std::vector<S16NESample> &samples) {
+    const auto *bytes = reinterpret_cast<const unsigned char *>(samples.data());
+    out.insert(out.end(), bytes, bytes + samples.size() * sizeof(S16NESample));
+}
+
+std::vector<unsigned char> makeWav(uint16_t channels, uint32_t rate, const std::vector<S16NESample> &samples) {
+    std::vector<unsigned char> out;
+    const uint32_t dataSize = samples.size() * sizeof(S16NESample);
+    appendTag(out, "RIFF");
+    appendLE(out, 4 + 8 + 16 + 8 + 3 + 1 + 8 + dataSize, 4);
+    appendTag(out, "WAVE");
+    appendTag(out, "fmt ");
+    appendLE(out, 16, 4);
+    appendLE(out, 1, 2);
+    appendLE(out, channels, 2);
+    appendLE(out, rate, 4);
+    appendLE(out, rate * channels * 2, 4);
+    appendLE(out, channels * 2, 2);
+    appendLE(out, 16, 2);
+    // An odd sized chunk the reader has to skip, including its padding byte
+    appendTag(out, "junk");
+    appendLE(out, 3, 4);
+    out.insert(out.end(), {1, 2, 3, 0});
+    appendTag(out, "data");
+    appendLE(out, dataSize, 4);
+    appendSamples(out, samples);
+    return out;
+}
+
+TEST(FileSourceTest, ReadsStereoWav) {
+    const std::vector<S16NESample> samples{1, -1, 2, -2, 3, -3};
+    TempFile file{makeWav(2, 44100, samples)};
+    FileSource source{file.path(), 48000};
+    EXPECT_EQ(44100u, source.sampleRate());
+    EXPECT_EQ(3u, source.numFrames());
+    std::vector<S16NESample> out(8, 99);
+    source.read(out.data(), 2);
+    EXPECT_FALSE(source.finished());
+    source.read(out.data() + 4, 2);
+    EXPECT_TRUE(source.finished());
+    EXPECT_EQ((std::vector<S16NESample>{1, -1, 2, -2, 3, -3, 0, 0}), out);
+}
+
+TEST(FileSourceTest, ReadsMonoWav) {
+    TempFile file{makeWav(1, 22050, {5, -7})};
+    FileSource source{file.path(), 48000};
+    EXPECT_EQ(1u, source.numChannels());
+    EXPECT_EQ(2u, source.numFrames());
+    std::vector<S16NESample> out(2);
+    source.read(out.data(), 2);
+    EXPECT_EQ((std::vector<S16NESample>{5, -7}), out);
+}
+
+TEST(FileSourceTest, ReadsRawStereo) {
+    std::vector<unsigned char> bytes;
+    appendSamples(bytes, {10, 20, 30, 40});
+    TempFile file{bytes};
+    FileSource source{file.path(), 32000};
+    EXPECT_EQ(32000u, source.sampleRate());
+    EXPECT_EQ(2u, source.numFrames());
+    std::vector<S16NESample> out(4);
+    source.read(out.data(), 2);
+    EXPECT_EQ((std::vector<S16NESample>{10, 20, 30, 40}), out);
+}
+
+TEST(FileSourceTest, RejectsUnsupportedWav) {
+    auto bytes = makeWav(2, 48000, {0, 0});
+    // Claim 24 bit samples
+    bytes[34] = 24;
+    TempFile file{bytes};
+    EXPECT_THROW((FileSource{file.path(), 48000}), std::runtime_error);
+}
+
+} // namespace
@@ -0,0 +1,104 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <frame_cache.h>
+
+namespace {
+
+using PulseView::Frame;
+using PulseView::FrameCache;
+using PulseView::S16NESample;
+using PulseView::fftw::WindowFunction;
+
+// One channel of a sinusoid completing cycles periods over the frame
+void loadSine(Frame &frame, double cycles) {
+    std::vector<S16NESample> samples(frame.numSamples);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<S16NESample>(std::lround(16384 * std::sin(2 * M_PI * cycles * i / samples.size())));
+    }
+    frame.loadInterleaved(samples.data(), 1);
+    frame.finalize();
+}
+
+TEST(FrameCacheTest, EvictsLeastRecentlyUsed) {
+    FrameCache cache{2, 3, 2};
+    auto small = cache.acquire(8, WindowFunction::Hann);
+    ASSERT_EQ(small->frames.size(), 3u);
+    EXPECT_EQ(small->log2Size, 8u);
+    EXPECT_EQ(small->frames.front()->numSamples, 256u);
+    EXPECT_EQ(small->frames.front()->numChannels, 2u);
+    EXPECT_EQ(small->frames.back()->fftw.window, WindowFunction::Hann);
+    const auto medium = cache.acquire(9, WindowFunction::Rectangular);
+    EXPECT_NE(medium->generation, small->generation);
+    EXPECT_EQ(cache.acquire(8, WindowFunction::Rectangular), small);
+    // A hit leaves the windows of frames that may be in use alone
+    EXPECT_EQ(small->frames.front()->fftw.window, WindowFunction::Hann);
+    cache.acquire(10, WindowFunction::Rectangular);
+    EXPECT_TRUE(cache.contains(8));
+    EXPECT_FALSE(cache.contains(9));
+    EXPECT_TRUE(cache.contains(10));
+    // Rebuilt after its eviction, and told apart from the old set
+    const auto rebuilt = cache.acquire(9, WindowFunction::Rectangular);
+    EXPECT_GT(rebuilt->generation, medium->generation);
+    const auto metrics = cache.metrics();
+    EXPECT_EQ(metrics.hits, 1u);
+    EXPECT_EQ(metrics.misses, 4u);
+    EXPECT_EQ(metrics.evictions, 2u);
+}
+
+TEST(FrameCacheTest, PreparesInTheBackground) {
+    FrameCache cache{1};
+    std::atomic<size_t> prepared{0};
+    const auto pending = cache.prepare(9, WindowFunction::Blackman, [&](PulseView::FrameSet &set) {
+        set.frames.front()->clear();
+        ++prepared;
+    });
+    EXPECT_EQ(pending->log2Size(), 9u);
+    std::shared_ptr<PulseView::FrameSet> set;
+    while (!(set = pending->ready())) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(prepared.load(), 1u);
+    EXPECT_EQ(set->log2Size, 9u);
+    EXPECT_EQ(set->frames.front()->fftw.window, WindowFunction::Blackman);
+    EXPECT_TRUE(cache.contains(9));
+    EXPECT_EQ(cache.acquire(9, WindowFunction::Rectangular), set);
+}
+
+TEST(FrameCacheTest, DestroyedWithPreparationsQueued) {
+    for (size_t i = 0; i < 8; ++i) {
+        FrameCache cache{1};
+        for (size_t log2Size = 6; log2Size < 10; ++log2Size) {
+            cache.prepare(log2Size, WindowFunction::Hann);
+        }
+    }
+}
+
+TEST(FrameCacheTest, WindowKeepsPeaksAndCutsLeakage) {
+    FrameCache cache{1};
+    auto &frame = *cache.acquire(10, WindowFunction::Rectangular)->frames.front();
+    loadSine(frame, 64);
+    const auto rectangularPeak = frame.getChunk(0).dft[64];
+    loadSine(frame, 64.5);
+    const auto rectangularLeakage = frame.getChunk(0).dft[96];
+    for (auto window : {WindowFunction::Hann, WindowFunction::Hamming, WindowFunction::Blackman}) {
+        frame.setWindow(window);
+        loadSine(frame, 64);
+        EXPECT_NEAR(frame.getChunk(0).dft[64], rectangularPeak, rectangularPeak * 1e-6)
+            << PulseView::fftw::windowFunctionName(window);
+        loadSine(frame, 64.5);
+        EXPECT_LT(frame.getChunk(0).dft[96], rectangularLeakage / 4) << PulseView::fftw::windowFunctionName(window);
+    }
+}
+
+} // namespace
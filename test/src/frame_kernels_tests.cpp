@@ -0,0 +1,87 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <frame_kernels.h>
+
+namespace {
+
+using namespace PulseView;
+using Kernels = kernels::FrameKernels<Sample>;
+
+// Specialised kernels only drop runtime sizes, so they must agree bit for bit with the generic ones
+void expectSameOutput(const Kernels &specialised, const Kernels &generic, size_t size, size_t numChannels) {
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> sampleDist{-32768, 32767};
+    std::uniform_real_distribution<Sample> valueDist{-1, 1};
+
+    std::vector<S16NESample> interleaved(size * numChannels);
+    for (auto &s : interleaved) {
+        s = static_cast<S16NESample>(sampleDist(rng));
+    }
+    fftw::FFTWVector<Sample> samples(size * numChannels), expectedSamples(size * numChannels);
+    std::vector<Sample *> rows(numChannels), expectedRows(numChannels);
+    for (size_t c = 0; c < numChannels; ++c) {
+        rows[c] = samples.data() + c * size;
+        expectedRows[c] = expectedSamples.data() + c * size;
+    }
+    specialised.load(interleaved.data(), size, numChannels, rows.data());
+    generic.load(interleaved.data(), size, numChannels, expectedRows.data());
+    EXPECT_EQ(samples, expectedSamples);
+
+    fftw::FFTWVector<Sample> coefficients(size), windowed(size), expectedWindowed(size);
+    for (auto &w : coefficients) {
+        w = valueDist(rng);
+    }
+    specialised.window(samples.data(), coefficients.data(), size, windowed.data());
+    generic.window(samples.data(), coefficients.data(), size, expectedWindowed.data());
+    EXPECT_EQ(windowed, expectedWindowed);
+
+    fftw::FFTWVector<Kernels::Complex> bins(size / 2 + 1);
+    for (auto &bin : bins) {
+        bin.value[0] = valueDist(rng);
+        bin.value[1] = valueDist(rng);
+    }
+    fftw::FFTWVector<Sample> spectrum(bins.size()), expectedSpectrum(bins.size());
+    specialised.magnitude(bins.data(), size, spectrum.data());
+    generic.magnitude(bins.data(), size, expectedSpectrum.data());
+    EXPECT_EQ(spectrum, expectedSpectrum);
+    specialised.power(bins.data(), size, spectrum.data());
+    generic.power(bins.data(), size, expectedSpectrum.data());
+    EXPECT_EQ(spectrum, expectedSpectrum);
+
+    constexpr size_t numColumns = 300;
+    std::vector<Sample> mins(numColumns), maxs(numColumns), expectedMins(numColumns), expectedMaxs(numColumns);
+    specialised.envelope(samples.data(), size, numColumns, mins.data(), maxs.data());
+    generic.envelope(samples.data(), size, numColumns, expectedMins.data(), expectedMaxs.data());
+    EXPECT_EQ(mins, expectedMins);
+    EXPECT_EQ(maxs, expectedMaxs);
+}
+
+TEST(FrameKernelsTest, SpecialisedMatchGeneric) {
+    const auto &generic = kernels::frameKernels<Sample>(kernels::maxSpecialisedLog2Size + 1, 3);
+    ASSERT_FALSE(generic.specialised);
+    for (size_t log2Size : {kernels::minSpecialisedLog2Size, size_t{12}}) {
+        for (size_t numChannels : kernels::specialisedChannelCounts) {
+            SCOPED_TRACE(testing::Message() << "2^" << log2Size << " x " << numChannels);
+            const auto &specialised = kernels::frameKernels<Sample>(log2Size, numChannels);
+            ASSERT_TRUE(specialised.specialised);
+            expectSameOutput(specialised, generic, size_t{1} << log2Size, numChannels);
+        }
+    }
+}
+
+TEST(FrameKernelsTest, FallsBackOutsideTheTable) {
+    EXPECT_FALSE(kernels::frameKernels<Sample>(kernels::minSpecialisedLog2Size - 1, 2).specialised);
+    EXPECT_FALSE(kernels::frameKernels<Sample>(kernels::maxSpecialisedLog2Size + 1, 2).specialised);
+    EXPECT_FALSE(kernels::frameKernels<Sample>(10, 3).specialised);
+    EXPECT_TRUE(kernels::frameKernels<Sample>(10, 2).specialised);
+}
+
+} // namespace
@@ -0,0 +1,76 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include "gtest/gtest.h"
+
+#include <frame_pacer.h>
+
+namespace {
+
+using PulseView::FramePacer;
+using PulseView::RenderQuality;
+
+constexpr uint64_t period = 10000;
+
+TEST(FramePacerTest, DegradesOneLevelPerRunOfOverBudgetFrames) {
+    FramePacer pacer{period};
+    for (unsigned i = 1; i < FramePacer::overBudgetToDegrade; ++i) {
+        EXPECT_FALSE(pacer.frameRendered(period + 1));
+    }
+    EXPECT_TRUE(pacer.frameRendered(period + 1));
+    EXPECT_EQ(RenderQuality::FewerBars, pacer.quality());
+    // A frame within budget restarts the run
+    pacer.frameRendered(period);
+    for (unsigned i = 1; i < FramePacer::overBudgetToDegrade; ++i) {
+        pacer.frameRendered(period + 1);
+    }
+    EXPECT_EQ(RenderQuality::FewerBars, pacer.quality());
+    pacer.frameRendered(period + 1);
+    EXPECT_EQ(RenderQuality::Decimated, pacer.quality());
+    EXPECT_EQ(2u, pacer.metrics().degradations);
+    EXPECT_EQ(2 * FramePacer::overBudgetToDegrade, pacer.metrics().overBudget);
+}
+
+TEST(FramePacerTest, StopsAtLowestQuality) {
+    FramePacer pacer{period};
+    pacer.setLowestQuality(RenderQuality::Decimated);
+    for (unsigned i = 0; i < 10 * FramePacer::overBudgetToDegrade; ++i) {
+        pacer.frameRendered(2 * period);
+    }
+    EXPECT_EQ(RenderQuality::Decimated, pacer.quality());
+}
+
+TEST(FramePacerTest, RecoversAfterSustainedHeadroom) {
+    FramePacer pacer{period};
+    for (unsigned i = 0; i < FramePacer::overBudgetToDegrade; ++i) {
+        pacer.frameRendered(2 * period);
+    }
+    ASSERT_EQ(RenderQuality::FewerBars, pacer.quality());
+    // Frames using more than half the period don't count towards recovering
+    for (unsigned i = 0; i < 2 * FramePacer::underBudgetToRecover; ++i) {
+        pacer.frameRendered(period / 2 + 1);
+    }
+    EXPECT_EQ(RenderQuality::FewerBars, pacer.quality());
+    for (unsigned i = 1; i < FramePacer::underBudgetToRecover; ++i) {
+        EXPECT_FALSE(pacer.frameRendered(period / 2));
+    }
+    EXPECT_TRUE(pacer.frameRendered(period / 2));
+    EXPECT_EQ(RenderQuality::Full, pacer.quality());
+    EXPECT_EQ(1u, pacer.metrics().recoveries);
+}
+
+TEST(FramePacerTest, FixedQualityOnlyCounts) {
+    FramePacer pacer{period};
+    pacer.setAdaptive(false);
+    for (unsigned i = 0; i < 10 * FramePacer::overBudgetToDegrade; ++i) {
+        EXPECT_FALSE(pacer.frameRendered(2 * period));
+    }
+    pacer.frameSkipped();
+    EXPECT_EQ(RenderQuality::Full, pacer.quality());
+    EXPECT_EQ(10 * FramePacer::overBudgetToDegrade, pacer.metrics().framesAtQuality[0]);
+    EXPECT_EQ(1u, pacer.metrics().framesSkipped);
+}
+
+} // namespace
@@ -0,0 +1,69 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include <capture_thread.h>
+#include <frame_switcher.h>
+#include <synthetic_source.h>
+
+namespace {
+
+using namespace PulseView;
+
+constexpr size_t log2WindowFrames = 10;
+constexpr size_t hopFrames = 256;
+
+float loudest(const Frame &frame) {
+    const auto &samples = frame.getChunk(0).samples;
+    return *std::max_element(samples.begin(), samples.end());
+}
+
+// Analyses captured audio until the switcher has moved on to a frame of log2Size
+Frame &switchTo(FrameSwitcher &switcher, CaptureThread &capture, size_t log2Size) {
+    while (!switcher.update(log2Size) || switcher.current().log2Size != log2Size) {
+        capture.populateFrame(switcher.current());
+        std::this_thread::yield();
+    }
+    return switcher.current();
+}
+
+TEST(FrameSwitcherTest, SeedsNewSizesWithoutAHistory) {
+    AudioSource::SyntheticSource source{AudioSource::Signal::Sine, 48000};
+    Frame frame{log2WindowFrames, source.numChannels(), fftw::PlannerEffort::Estimate};
+    CaptureThread capture{source, frame.numSamples, hopFrames};
+    FrameSwitcher switcher{capture, frame};
+    // Enough audio for the larger frame
+    while (switcher.recentAudio().framesWritten() < 4 * frame.numSamples) {
+        switcher.update(log2WindowFrames);
+        capture.populateFrame(switcher.current());
+    }
+    // Checked before anything else is captured into them, as a cleared frame would stay silent until it refilled
+    EXPECT_GT(loudest(switchTo(switcher, capture, log2WindowFrames + 2)), 0.4);
+    EXPECT_GT(loudest(switchTo(switcher, capture, log2WindowFrames)), 0.4);
+    EXPECT_EQ(&switcher.current(), &frame);
+    EXPECT_GT(loudest(switchTo(switcher, capture, log2WindowFrames + 2)), 0.4);
+    // Switching back found the set still cached
+    const auto metrics = switcher.metrics();
+    EXPECT_EQ(metrics.misses, 1u);
+    EXPECT_EQ(metrics.hits, 1u);
+}
+
+TEST(FrameSwitcherTest, KeepsTheCurrentFrameUntilTheNextIsReady) {
+    AudioSource::SyntheticSource source{AudioSource::Signal::Sine, 48000};
+    Frame frame{log2WindowFrames, source.numChannels(), fftw::PlannerEffort::Estimate};
+    CaptureThread capture{source, frame.numSamples, hopFrames};
+    FrameSwitcher switcher{capture, frame};
+    switcher.update(log2WindowFrames);
+    switcher.update(log2WindowFrames + 1);
+    // Preparing has only just been asked for
+    EXPECT_EQ(&switcher.current(), &frame);
+    EXPECT_EQ(switchTo(switcher, capture, log2WindowFrames + 1).numSamples, 2 * frame.numSamples);
+}
+
+} // namespace
@@ -0,0 +1,67 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <latency_stats.h>
+
+namespace {
+
+using PulseView::LatencyHistogram;
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(0u, histogram.count());
+    EXPECT_EQ(0u, histogram.percentile(0.5));
+    EXPECT_EQ(0u, histogram.max());
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketPrecision) {
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 10000; ++v) {
+        histogram.record(v);
+    }
+    EXPECT_EQ(10000u, histogram.count());
+    EXPECT_EQ(10000u, histogram.max());
+    for (double p : {0.01, 0.5, 0.9, 0.99}) {
+        const double exact = p * 10000;
+        const auto reported = histogram.percentile(p);
+        EXPECT_GE(reported, exact);
+        EXPECT_LE(reported, exact * 1.25);
+    }
+    EXPECT_EQ(10000u, histogram.percentile(1.));
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    histogram.record(0);
+    histogram.record(3);
+    histogram.record(3);
+    EXPECT_EQ(0u, histogram.percentile(0.3));
+    EXPECT_EQ(3u, histogram.percentile(0.5));
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreAllCounted) {
+    LatencyHistogram histogram;
+    constexpr size_t perThread = 100000;
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (size_t i = 0; i < perThread; ++i) {
+                histogram.record(t * 1000 + i % 1000);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(4 * perThread, histogram.count());
+    EXPECT_EQ(3999u, histogram.max());
+}
+
+} // namespace
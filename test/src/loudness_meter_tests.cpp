@@ -0,0 +1,106 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <loudness_meter.h>
+#include <render_model.h>
+
+namespace {
+
+using PulseView::Frame;
+using PulseView::LoudnessMeter;
+using PulseView::S16NESample;
+using PulseView::toDecibels;
+
+constexpr size_t sampleRate = 48000;
+
+// seconds of a stereo sine at peakDecibels dBFS, the same in both channels
+std::vector<S16NESample> stereoSine(double frequency, double peakDecibels, double seconds, double phase = 0.) {
+    const auto numFrames = static_cast<size_t>(seconds * sampleRate);
+    const double amplitude = 32767. * std::pow(10., peakDecibels / 20.);
+    std::vector<S16NESample> interleaved(2 * numFrames);
+    for (size_t i = 0; i < numFrames; ++i) {
+        const auto sample = std::lround(amplitude * std::sin(2. * M_PI * frequency * i / sampleRate + phase));
+        interleaved[2 * i] = interleaved[2 * i + 1] = static_cast<S16NESample>(sample);
+    }
+    return interleaved;
+}
+
+// In uneven blocks, as frames arrive
+void feed(LoudnessMeter &meter, const std::vector<S16NESample> &interleaved) {
+    const size_t numFrames = interleaved.size() / 2;
+    for (size_t done = 0, block = 1; done < numFrames; block = block * 7 % 4093 + 1) {
+        const auto n = std::min(block, numFrames - done);
+        meter.processInterleaved(interleaved.data() + 2 * done, n);
+        done += n;
+    }
+}
+
+// EBU Tech 3341's first case: a 1 kHz sine at -23 dBFS in both channels reads -23 LUFS
+TEST(LoudnessMeterTest, SineReadsItsLevel) {
+    LoudnessMeter meter{2, sampleRate};
+    feed(meter, stereoSine(1000., -23., 10.));
+    const auto loudness = meter.loudness();
+    EXPECT_NEAR(loudness.momentary, -23., .1);
+    EXPECT_NEAR(loudness.shortTerm, -23., .1);
+    EXPECT_NEAR(loudness.integrated, -23., .1);
+    for (size_t c = 0; c < 2; ++c) {
+        const auto &levels = meter.levels(c);
+        EXPECT_NEAR(toDecibels(levels.peak), -23., .01);
+        EXPECT_NEAR(toDecibels(levels.rms), -23. - 10. * std::log10(2.), .01);
+        EXPECT_NEAR(toDecibels(levels.truePeak), -23., .1);
+    }
+}
+
+// A quarter of the sample rate sampled 45 degrees off its peaks only ever reaches 0.707 of it between samples
+TEST(LoudnessMeterTest, TruePeakFindsPeaksBetweenSamples) {
+    LoudnessMeter meter{2, sampleRate};
+    feed(meter, stereoSine(sampleRate / 4., -6., 1., M_PI / 4.));
+    const auto &levels = meter.levels(0);
+    EXPECT_NEAR(toDecibels(levels.peak), -9., .1);
+    EXPECT_NEAR(toDecibels(levels.truePeak), -6., .5);
+    EXPECT_GE(levels.maxTruePeak, levels.truePeak);
+}
+
+// Silence falls under the absolute gate and anything 10 LU below the rest under the relative one
+TEST(LoudnessMeterTest, IntegratedLoudnessIsGated) {
+    LoudnessMeter meter{2, sampleRate};
+    feed(meter, stereoSine(1000., -23., 10.));
+    feed(meter, stereoSine(1000., -50., 10.));
+    feed(meter, std::vector<S16NESample>(2 * 10 * sampleRate));
+    EXPECT_NEAR(meter.loudness().integrated, -23., .1);
+    EXPECT_EQ(meter.loudness().momentary, -std::numeric_limits<double>::infinity());
+    meter.reset();
+    EXPECT_EQ(meter.loudness().integrated, -std::numeric_limits<double>::infinity());
+    feed(meter, stereoSine(1000., -30., 5.));
+    EXPECT_NEAR(meter.loudness().integrated, -30., .1);
+}
+
+// Metering blocks as a frame converts them reads the same as metering the interleaved samples
+TEST(LoudnessMeterTest, FrameMetersWhatItConverts) {
+    const auto interleaved = stereoSine(997., -12., 3.);
+    LoudnessMeter direct{2, sampleRate}, fused{2, sampleRate};
+    feed(direct, interleaved);
+    Frame frame{10, 2, PulseView::fftw::PlannerEffort::Estimate};
+    // Both more and fewer frames than the window at a time
+    const size_t numFrames = interleaved.size() / 2;
+    for (size_t done = 0, hop = 300; done < numFrames; hop = hop == 300 ? 2500 : 300) {
+        const auto n = std::min(hop, numFrames - done);
+        frame.advance(interleaved.data() + 2 * done, n, 2, &fused);
+        done += n;
+    }
+    EXPECT_NEAR(fused.loudness().integrated, direct.loudness().integrated, 1e-4);
+    for (size_t c = 0; c < 2; ++c) {
+        EXPECT_NEAR(fused.levels(c).truePeak, direct.levels(c).truePeak, 1e-5);
+        EXPECT_NEAR(fused.levels(c).rms, direct.levels(c).rms, 1e-5);
+    }
+}
+
+} // namespace
@@ -0,0 +1,102 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <capture_thread.h>
+#include <pcm_process_source.h>
+
+namespace {
+
+using PulseView::S16NESample;
+using PulseView::AudioSource::PCMProcessSource;
+using PulseView::AudioSource::PCMStreamConfig;
+using PulseView::conversion::SampleFormat;
+
+PCMStreamConfig commandConfig(const std::string &command, SampleFormat format, size_t numChannels) {
+    PCMStreamConfig config;
+    config.command = command;
+    config.format = format;
+    config.numChannels = numChannels;
+    return config;
+}
+
+TEST(PCMProcessSourceTest, ReadsStereoFromCommand) {
+    // 1, -1, 2, -2 as little endian S16
+    PCMProcessSource source{commandConfig("printf '\\001\\000\\377\\377\\002\\000\\376\\377'", SampleFormat::S16NE, 2)};
+    std::vector<S16NESample> out(4);
+    source.read(out.data(), 2);
+    EXPECT_EQ((std::vector<S16NESample>{1, -1, 2, -2}), out);
+}
+
+TEST(PCMProcessSourceTest, ConvertsMonoS32) {
+    // 0x00010000 and 0xFFFF0000 as little endian S32
+    PCMProcessSource source{commandConfig("printf '\\000\\000\\001\\000\\000\\000\\377\\377'", SampleFormat::S32NE, 1)};
+    ASSERT_EQ(1u, source.numChannels());
+    std::vector<S16NESample> out(2);
+    source.read(out.data(), 2);
+    EXPECT_EQ((std::vector<S16NESample>{1, -1}), out);
+}
+
+TEST(PCMProcessSourceTest, KeepsEveryChannel) {
+    PCMProcessSource source{
+        commandConfig("printf '\\001\\000\\002\\000\\003\\000\\004\\000\\005\\000\\006\\000'", SampleFormat::S16NE, 3)};
+    ASSERT_EQ(3u, source.numChannels());
+    std::vector<S16NESample> out(6);
+    source.read(out.data(), 2);
+    EXPECT_EQ((std::vector<S16NESample>{1, 2, 3, 4, 5, 6}), out);
+}
+
+TEST(PCMProcessSourceTest, ThrowsWhenTheCommandExits) {
+    PCMProcessSource source{commandConfig("printf '\\001\\000\\002\\000'", SampleFormat::S16NE, 2)};
+    std::vector<S16NESample> out(4);
+    EXPECT_THROW(source.read(out.data(), 2), std::runtime_error);
+}
+
+TEST(PCMProcessSourceTest, WaitsForDataOnADescriptor) {
+    int fildes[2];
+    ASSERT_EQ(0, pipe(fildes));
+    PCMStreamConfig config;
+    config.fd = fildes[0];
+    PCMProcessSource source{config};
+    std::thread writer{[&] {
+        const S16NESample samples[] = {7, 8, 9, 10};
+        for (const auto &sample : samples) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            EXPECT_EQ(static_cast<ssize_t>(sizeof(sample)), write(fildes[1], &sample, sizeof(sample)));
+        }
+    }};
+    std::vector<S16NESample> out(4);
+    source.read(out.data(), 2);
+    writer.join();
+    EXPECT_EQ((std::vector<S16NESample>{7, 8, 9, 10}), out);
+    close(fildes[0]);
+    close(fildes[1]);
+}
+
+// An idle producer mustn't keep the capture thread from stopping
+TEST(PCMProcessSourceTest, InterruptWakesABlockedRead) {
+    int fildes[2];
+    ASSERT_EQ(0, pipe(fildes));
+    PCMStreamConfig config;
+    config.fd = fildes[0];
+    PCMProcessSource source{config};
+    {
+        PulseView::CaptureThread capture{source, 1024, 256};
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    std::vector<S16NESample> out(4);
+    // Stays interrupted
+    source.read(out.data(), 2);
+    close(fildes[0]);
+    close(fildes[1]);
+}
+
+} // namespace
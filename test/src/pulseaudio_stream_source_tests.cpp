@@ -0,0 +1,65 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+// Needs a running PulseAudio daemon, so these only run when PULSEVIEW_PULSE_TEST_DEVICE names a source to record
+// from, e.g. after
+//   pactl load-module module-null-sink sink_name=pulseview_test
+//   export PULSEVIEW_PULSE_TEST_DEVICE=pulseview_test.monitor
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <pulseaudio_stream_source.h>
+
+namespace {
+
+using PulseView::S16NESample;
+using PulseView::AudioSource::PulseAudioStreamSource;
+
+constexpr size_t sampleRate = 48000;
+constexpr size_t fragmentFrames = 480;
+
+class PulseAudioStreamSourceTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        const char *env = std::getenv("PULSEVIEW_PULSE_TEST_DEVICE");
+        if (!env) {
+            GTEST_SKIP() << "PULSEVIEW_PULSE_TEST_DEVICE is not set";
+        }
+        device = env;
+    }
+    std::string device;
+};
+
+TEST_F(PulseAudioStreamSourceTest, RecordsSilenceFromAnIdleNullSink) {
+    PulseAudioStreamSource source{sampleRate, fragmentFrames, device};
+    // Half a second of audio should take about half a second, with no long stall on the first read
+    std::vector<S16NESample> buffer(sampleRate / 2 * source.numChannels(), 1);
+    const auto start = std::chrono::steady_clock::now();
+    source.read(buffer.data(), sampleRate / 2);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::seconds(2));
+    EXPECT_TRUE(std::all_of(buffer.begin(), buffer.end(), [](S16NESample s) { return s == 0; }));
+    EXPECT_LT(source.latencyMicros(), 1000000u);
+}
+
+TEST_F(PulseAudioStreamSourceTest, ReadsInPiecesSmallerThanAFragment) {
+    PulseAudioStreamSource source{sampleRate, fragmentFrames, device};
+    std::vector<S16NESample> buffer(7 * source.numChannels());
+    for (size_t i = 0; i < 1000; ++i) {
+        source.read(buffer.data(), 7);
+    }
+}
+
+TEST_F(PulseAudioStreamSourceTest, RejectsUnknownDevice) {
+    EXPECT_THROW((PulseAudioStreamSource{sampleRate, fragmentFrames, "pulseview-no-such-source"}), std::runtime_error);
+}
+
+} // namespace
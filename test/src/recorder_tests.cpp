@@ -0,0 +1,76 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <file_source.h>
+#include <recorder.h>
+
+namespace {
+
+using PulseView::RecordFormat;
+using PulseView::Recorder;
+using PulseView::S16NESample;
+
+std::vector<S16NESample> ramp(size_t numSamples) {
+    std::vector<S16NESample> samples(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        samples[i] = static_cast<S16NESample>(i * 7);
+    }
+    return samples;
+}
+
+std::vector<S16NESample> readBack(const std::string &path, size_t numChannels) {
+    PulseView::AudioSource::FileSource source{path, 48000, numChannels};
+    EXPECT_EQ(numChannels, source.numChannels());
+    std::vector<S16NESample> samples(source.numFrames() * numChannels);
+    source.read(samples.data(), source.numFrames());
+    return samples;
+}
+
+TEST(RecorderTest, RecordsEverythingPushed) {
+    constexpr size_t numChannels = 3;
+    constexpr size_t sampleRate = 192000;
+    // Under the queue's four seconds, so nothing is dropped however slow the disk is, and not a whole number of
+    // writes or blocks, so the tail is padded and trimmed
+    constexpr size_t numFrames = 567891;
+    static_assert(numFrames < 4 * sampleRate);
+    const auto samples = ramp(numFrames * numChannels);
+    for (auto format : {RecordFormat::WAV, RecordFormat::Raw}) {
+        const std::string path = testing::TempDir() + "recorder_test";
+        {
+            Recorder recorder{numChannels, sampleRate, format, path};
+            for (size_t f = 0; f < numFrames; f += 1000) {
+                recorder.push(samples.data() + f * numChannels, std::min<size_t>(1000, numFrames - f));
+            }
+            ASSERT_EQ(recorder.metrics().droppedFrames, 0u);
+        }
+        EXPECT_EQ(samples, readBack(path, numChannels));
+        std::remove(path.c_str());
+    }
+}
+
+TEST(RecorderTest, SnapshotHoldsTheNewestFrames) {
+    constexpr size_t numChannels = 2;
+    constexpr size_t preTriggerFrames = 10000;
+    const auto samples = ramp(25000 * numChannels);
+    const std::string path = testing::TempDir() + "recorder_snapshot_test.wav";
+    {
+        Recorder recorder{numChannels, 48000, RecordFormat::WAV, {}, preTriggerFrames};
+        for (size_t f = 0; f < 25000; f += 300) {
+            recorder.push(samples.data() + f * numChannels, std::min<size_t>(300, 25000 - f));
+        }
+        recorder.saveSnapshot(path);
+    }
+    const std::vector<S16NESample> newest(samples.end() - preTriggerFrames * numChannels, samples.end());
+    EXPECT_EQ(newest, readBack(path, numChannels));
+    std::remove(path.c_str());
+}
+
+} // namespace
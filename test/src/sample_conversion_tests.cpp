@@ -0,0 +1,104 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <sample_conversion.h>
+
+using namespace PulseView::conversion;
+
+class SampleConversionTest : public ::testing::TestWithParam<Kernel> {
+  protected:
+    virtual void SetUp() {
+        if (!kernelSupported(GetParam())) {
+            GTEST_SKIP() << kernelName(GetParam()) << " is not supported on this CPU";
+        }
+    }
+
+    template <typename T> void verify(SampleFormat format, const std::vector<T> &in, size_t numChannels) {
+        verifyPrecision<double>(format, in, numChannels);
+        verifyPrecision<float>(format, in, numChannels);
+    }
+
+    // Converts with the kernel under test and with the scalar kernel, and requires identical bits
+    template <typename Out, typename T>
+    void verifyPrecision(SampleFormat format, const std::vector<T> &in, size_t numChannels) {
+        const auto numFrames = in.size() / numChannels;
+        // pad so overruns past numFrames would show up as a mismatch
+        std::vector<std::vector<Out>> expected(numChannels, std::vector<Out>(numFrames + 8, -2));
+        std::vector<std::vector<Out>> actual(numChannels, std::vector<Out>(numFrames + 8, -2));
+        std::vector<Out *> expectedOut, actualOut;
+        for (size_t c = 0; c < numChannels; ++c) {
+            expectedOut.push_back(expected[c].data());
+            actualOut.push_back(actual[c].data());
+        }
+        deinterleave(Kernel::Scalar, in.data(), format, numChannels, numFrames, expectedOut.data());
+        deinterleave(GetParam(), in.data(), format, numChannels, numFrames, actualOut.data());
+        for (size_t c = 0; c < numChannels; ++c) {
+            EXPECT_EQ(0, std::memcmp(expected[c].data(), actual[c].data(), expected[c].size() * sizeof(Out)))
+                << "channel " << c << " of " << numChannels << ", " << numFrames << " frames";
+        }
+    }
+
+    template <typename T> std::vector<T> randomSamples(size_t numSamples, T lo, T hi) {
+        std::uniform_int_distribution<long long> dist{lo, hi};
+        std::vector<T> rv(numSamples);
+        for (auto &sample : rv) {
+            sample = static_cast<T>(dist(rng));
+        }
+        return rv;
+    }
+
+    std::mt19937 rng{42};
+    const std::vector<size_t> frameCounts{0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 1000, 1027};
+};
+
+TEST_P(SampleConversionTest, S16MatchesScalar) {
+    for (size_t numChannels = 1; numChannels <= 8; ++numChannels) {
+        for (auto numFrames : frameCounts) {
+            verify(SampleFormat::S16NE,
+                   randomSamples<int16_t>(numFrames * numChannels, std::numeric_limits<int16_t>::min(),
+                                          std::numeric_limits<int16_t>::max()),
+                   numChannels);
+        }
+    }
+}
+
+TEST_P(SampleConversionTest, S16Extremes) {
+    const std::vector<int16_t> in{std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max(), 0, -1,
+                                  1, 0, std::numeric_limits<int16_t>::max(), std::numeric_limits<int16_t>::min()};
+    verify(SampleFormat::S16NE, in, 1);
+    verify(SampleFormat::S16NE, in, 2);
+    std::vector<double> left(4), right(4);
+    double *out[] = {left.data(), right.data()};
+    deinterleave(GetParam(), in.data(), SampleFormat::S16NE, 2, 4, out);
+    EXPECT_EQ(1., right[0]);
+    EXPECT_EQ(0., left[1]);
+    EXPECT_EQ(-1. / std::numeric_limits<int16_t>::max(), right[1]);
+    EXPECT_EQ(std::numeric_limits<int16_t>::min() / (double)std::numeric_limits<int16_t>::max(), right[3]);
+}
+
+TEST_P(SampleConversionTest, S32AndF32MatchScalar) {
+    for (auto numFrames : frameCounts) {
+        verify(SampleFormat::S32NE,
+               randomSamples<int32_t>(numFrames * 2, std::numeric_limits<int32_t>::min(),
+                                      std::numeric_limits<int32_t>::max()),
+               2);
+        std::vector<float> floats(numFrames * 2);
+        std::uniform_real_distribution<float> dist{-1.f, 1.f};
+        for (auto &sample : floats) {
+            sample = dist(rng);
+        }
+        verify(SampleFormat::F32NE, floats, 2);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernels, SampleConversionTest, ::testing::Values(Kernel::Scalar, Kernel::SSE2, Kernel::AVX2),
+                         [](const ::testing::TestParamInfo<Kernel> &info) { return kernelName(info.param); });
@@ -0,0 +1,113 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <signal_history.h>
+
+namespace {
+
+using PulseView::S16NESample;
+using PulseView::SampleSummary;
+using PulseView::SignalHistory;
+
+// Summarises [begin, end) of one channel of everything appended by scanning it
+SampleSummary bruteForce(const std::vector<S16NESample> &interleaved, size_t numChannels, size_t channel,
+                         int64_t begin, int64_t end) {
+    const auto numFrames = static_cast<int64_t>(interleaved.size() / numChannels);
+    begin = std::max<int64_t>(begin, 0);
+    end = std::min(end, numFrames);
+    if (begin >= end) {
+        return {0.f, 0.f, 0.f};
+    }
+    float lo = 1.f, hi = -1.f;
+    double sumSquares = 0.;
+    for (auto f = begin; f < end; ++f) {
+        const float v = interleaved[f * numChannels + channel] / 32767.f;
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+        sumSquares += v * v;
+    }
+    return {lo, hi, static_cast<float>(std::sqrt(sumSquares / (end - begin)))};
+}
+
+std::vector<S16NESample> noise(size_t numSamples) {
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> dist{-32768, 32767};
+    std::vector<S16NESample> samples(numSamples);
+    for (auto &s : samples) {
+        s = static_cast<S16NESample>(dist(rng));
+    }
+    return samples;
+}
+
+void expectSummariesMatch(const SignalHistory &history, const std::vector<S16NESample> &interleaved, uint64_t end,
+                          uint64_t span, size_t numColumns) {
+    std::vector<SampleSummary> summaries(numColumns);
+    for (size_t c = 0; c < history.numChannels(); ++c) {
+        history.summarise(c, end, span, numColumns, summaries.data());
+        const auto start = static_cast<int64_t>(end) - static_cast<int64_t>(span);
+        for (size_t i = 0; i < numColumns; ++i) {
+            const auto expected = bruteForce(interleaved, history.numChannels(), c, start + i * span / numColumns,
+                                             start + (i + 1) * span / numColumns);
+            EXPECT_EQ(expected.min, summaries[i].min);
+            EXPECT_EQ(expected.max, summaries[i].max);
+            EXPECT_NEAR(expected.rms, summaries[i].rms, 1e-5);
+        }
+    }
+}
+
+TEST(SignalHistoryTest, SummariesMatchScanningEverySample) {
+    constexpr size_t numChannels = 2;
+    constexpr size_t numFrames = 100000;
+    SignalHistory history{numChannels, numFrames};
+    ASSERT_GT(history.numLevels(), 3u);
+    const auto interleaved = noise(numFrames * numChannels);
+    // Odd sized appends, so entries close in the middle of them
+    for (size_t f = 0; f < numFrames; f += 997) {
+        history.append(interleaved.data() + f * numChannels, std::min<size_t>(997, numFrames - f));
+    }
+    EXPECT_EQ(numFrames, history.framesWritten());
+    expectSummariesMatch(history, interleaved, numFrames, numFrames, 640);
+    expectSummariesMatch(history, interleaved, numFrames - 12345, 54321, 333);
+    expectSummariesMatch(history, interleaved, 5000, 3000, 1000);
+    // Reaches back before the first frame
+    expectSummariesMatch(history, interleaved, 20000, 50000, 100);
+}
+
+TEST(SignalHistoryTest, ForgetsFramesOlderThanCapacity) {
+    constexpr size_t numChannels = 3;
+    SignalHistory history{numChannels, 4096};
+    const auto numFrames = 3 * history.capacityFrames() + 123;
+    const auto interleaved = noise(numFrames * numChannels);
+    history.append(interleaved.data(), numFrames);
+    EXPECT_EQ(numFrames - history.capacityFrames(), history.oldestFrame());
+    // Only what's still held is summarised
+    std::vector<S16NESample> held(interleaved.size());
+    std::copy(interleaved.begin() + history.oldestFrame() * numChannels, interleaved.end(),
+              held.begin() + history.oldestFrame() * numChannels);
+    expectSummariesMatch(history, held, numFrames, 2 * history.capacityFrames(), 256);
+}
+
+TEST(SignalHistoryTest, BacksOntoAFile) {
+    const std::string path = testing::TempDir() + "signal_history_test";
+    {
+        SignalHistory history{1, 1 << 16, path};
+        const auto interleaved = noise(1 << 16);
+        history.append(interleaved.data(), interleaved.size());
+        expectSummariesMatch(history, interleaved, 1 << 16, 1 << 16, 512);
+    }
+    std::remove(path.c_str());
+}
+
+} // namespace
@@ -0,0 +1,41 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <spectrum_layout.h>
+
+namespace {
+
+using PulseView::SpectrumLayout;
+using PulseView::SpectrumScale;
+
+constexpr size_t numBins = 1025;
+constexpr size_t sampleRate = 48000;
+
+class SpectrumLayoutTest : public ::testing::TestWithParam<SpectrumScale> {};
+
+// Bars sharing or repeating bins mustn't change their level, which would draw a comb over the low end
+TEST_P(SpectrumLayoutTest, FlatSpectrumGivesEqualBars) {
+    const std::vector<double> bins(numBins, 1.);
+    std::vector<double> prefix(numBins + 1);
+    // 128 bars, then one per pixel column of a typical window, more than there are low bins to go round
+    for (size_t numBars : {size_t{128}, size_t{800}}) {
+        const SpectrumLayout layout{numBins, numBars, GetParam(), sampleRate};
+        std::vector<double> bars(numBars);
+        layout.compute(bins.data(), prefix.data(), bars.data());
+        for (size_t i = 1; i < numBars; ++i) {
+            EXPECT_DOUBLE_EQ(bars[i], bars[0]) << "bar " << i << " of " << numBars;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Scales, SpectrumLayoutTest,
+                         ::testing::Values(SpectrumScale::Linear, SpectrumScale::Quadratic, SpectrumScale::Logarithmic,
+                                           SpectrumScale::Mel));
+
+} // namespace
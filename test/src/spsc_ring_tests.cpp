@@ -0,0 +1,106 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <spsc_ring.h>
+
+namespace {
+
+using PulseView::SPSCRing;
+
+TEST(SPSCRingTest, RoundsCapacityUpToAPowerOfTwo) {
+    EXPECT_EQ(SPSCRing<int>{1}.capacity(), 1u);
+    EXPECT_EQ(SPSCRing<int>{5}.capacity(), 8u);
+    EXPECT_EQ(SPSCRing<int>{8}.capacity(), 8u);
+}
+
+TEST(SPSCRingTest, EmptyAndFull) {
+    SPSCRing<int> ring{8};
+    int out[8];
+    EXPECT_EQ(ring.readAvailable(), 0u);
+    EXPECT_EQ(ring.pop(out, 8), 0u);
+    EXPECT_EQ(ring.discard(8), 0u);
+    std::vector<int> in(10);
+    std::iota(in.begin(), in.end(), 0);
+    // Only what fits goes in
+    EXPECT_EQ(ring.push(in.data(), in.size()), 8u);
+    EXPECT_EQ(ring.writeAvailable(), 0u);
+    EXPECT_EQ(ring.readAvailable(), 8u);
+    EXPECT_EQ(ring.push(in.data(), 1), 0u);
+    EXPECT_EQ(ring.pop(out, 8), 8u);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+    EXPECT_EQ(ring.writeAvailable(), 8u);
+}
+
+TEST(SPSCRingTest, WrapsAround) {
+    SPSCRing<int> ring{8};
+    int next = 0, expected = 0;
+    int in[5], out[5];
+    // Every push and pop of 5 starts at a different offset, so most of them straddle the end of the buffer
+    for (int round = 0; round < 20; ++round) {
+        for (auto &item : in) {
+            item = next++;
+        }
+        ASSERT_EQ(ring.push(in, 5), 5u);
+        ASSERT_EQ(ring.pop(out, 5), 5u);
+        for (auto item : out) {
+            EXPECT_EQ(item, expected++);
+        }
+    }
+    // Discarding across the end skips exactly what it says
+    ring.push(in, 5);
+    EXPECT_EQ(ring.discard(3), 3u);
+    EXPECT_EQ(ring.pop(out, 5), 2u);
+    EXPECT_EQ(out[0], in[3]);
+    EXPECT_EQ(out[1], in[4]);
+}
+
+// The consumer pops and discards while a producer pushes as fast as it can, and must see one in-order sequence with
+// gaps only where it discarded
+TEST(SPSCRingTest, ConcurrentProducer) {
+    constexpr uint32_t numItems = 1 << 18;
+    SPSCRing<uint32_t> ring{1024};
+    std::thread producer{[&] {
+        std::vector<uint32_t> block(37);
+        for (uint32_t next = 0; next < numItems;) {
+            const auto n = std::min<size_t>(block.size(), numItems - next);
+            for (size_t i = 0; i < n; ++i) {
+                block[i] = next + i;
+            }
+            size_t pushed = 0;
+            while (pushed < n) {
+                pushed += ring.push(block.data() + pushed, n - pushed);
+            }
+            next += n;
+        }
+    }};
+    std::vector<uint32_t> out(100);
+    uint32_t expected = 0;
+    size_t round = 0;
+    while (expected < numItems) {
+        if (++round % 7 == 0) {
+            expected += ring.discard(13);
+            continue;
+        }
+        const auto n = ring.pop(out.data(), out.size());
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(out[i], expected + i);
+        }
+        expected += n;
+    }
+    producer.join();
+    EXPECT_EQ(expected, numItems);
+    EXPECT_EQ(ring.readAvailable(), 0u);
+}
+
+} // namespace
@@ -0,0 +1,59 @@
+//
+// Author: Sahan Fernando <sahan.h.fernando@gmail.com>
+// Date: 2026-10-18
+//
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <task_pool.h>
+
+namespace {
+
+using PulseView::TaskPool;
+
+TEST(TaskPoolTest, RunsEveryTaskOnce) {
+    TaskPool pool{3};
+    for (size_t numTasks : {0, 1, 2, 7, 64}) {
+        std::vector<std::atomic<int>> calls(numTasks);
+        pool.parallelFor(numTasks, [&](size_t i) { ++calls[i]; });
+        for (const auto &count : calls) {
+            EXPECT_EQ(1, count.load());
+        }
+    }
+}
+
+TEST(TaskPoolTest, WorksWithoutThreads) {
+    TaskPool pool{0};
+    size_t sum = 0;
+    pool.parallelFor(5, [&](size_t i) { sum += i; });
+    EXPECT_EQ(10u, sum);
+}
+
+TEST(TaskPoolTest, RunsPostedTasks) {
+    for (size_t numThreads : {0, 2}) {
+        TaskPool pool{numThreads};
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t ran = 0;
+        for (size_t i = 0; i < 5; ++i) {
+            pool.post([&] {
+                std::lock_guard<std::mutex> lock{mutex};
+                ++ran;
+                done.notify_one();
+            });
+        }
+        // Jobs from parallelFor aren't held up by them
+        std::atomic<size_t> sum{0};
+        pool.parallelFor(5, [&](size_t i) { sum += i; });
+        EXPECT_EQ(10u, sum);
+        std::unique_lock<std::mutex> lock{mutex};
+        done.wait(lock, [&] { return ran == 5; });
+    }
+}
+
+} // namespace